@@ -0,0 +1,81 @@
+#ifndef ARIAC_EXAMPLE_ARM_KINEMATICS_H
+#define ARIAC_EXAMPLE_ARM_KINEMATICS_H
+
+#include <array>
+
+#include "ariac_example/joint_index.h"
+
+typedef std::array<double, 3> Vec3;
+
+/// Where the gripper is and which way it points, in the world frame.
+struct ToolPose {
+  Vec3 position;
+  Vec3 axis;  ///< unit vector along the gripper, pointing away from the wrist
+};
+
+/*
+ * @brief Kinematics of the UR10 riding on the linear_arm_actuator_joint rail.
+ *
+ * Forward kinematics uses the standard UR10 DH parameters, with the DH base
+ * frame placed in the world at rail position 0 and moved along world y by
+ * the rail joint. refine() is the numeric inverse: damped least squares on
+ * the gripper position with the gripper pointing straight down, over the
+ * rail and the first five arm joints (wrist_3 only spins the vacuum cup and
+ * is kept from the seed). It is meant to start from a nearby solution, such
+ * as an IkTable cell, and converges in a handful of iterations from there.
+ */
+class ArmKinematics
+{
+public:
+  ArmKinematics();
+
+  /*
+   * @brief Place the DH base frame in the world
+   * @param origin: base origin at rail position 0
+   * @param yaw: rotation of the base frame about world z
+   */
+  void set_base(const Vec3 & origin, double yaw);
+
+  /// Distance from the wrist_3 flange to the point that touches the part.
+  void set_tool_length(double length);
+
+  void set_rail_limits(double lower, double upper);
+
+  void forward(const JointPositions & q, ToolPose & pose) const;
+
+  /// Points along the arm: the base on the rail, the five joint frames after it, and the tool.
+  static const size_t kLinkPoints = 7;
+  typedef std::array<Vec3, kLinkPoints> LinkPoints;
+  void link_points(const JointPositions & q, LinkPoints & points) const;
+
+  /*
+   * @brief Move q towards a gripper position with the gripper pointing down
+   * @param target: world position for the gripper
+   * @param q: seed on input, solution on output (also when not converged)
+   * @param max_iterations: damped least-squares steps to take at most
+   * @param tolerance: position error (m) and axis tilt (rad) accepted
+   * @param error: if set, the final position error
+   * @return whether it converged within the tolerance
+   */
+  bool refine(const Vec3 & target, JointPositions & q, int max_iterations,
+              double tolerance, double * error = NULL) const;
+
+private:
+  struct Frames {
+    Vec3 origin[6];  ///< origin of the frame each arm joint rotates in
+    Vec3 axis[6];    ///< rotation axis of each arm joint
+    Vec3 tool;
+    Vec3 tool_axis;
+  };
+
+  void chain(const JointPositions & q, Frames & frames) const;
+
+  Vec3 base_origin_;
+  double base_cos_;
+  double base_sin_;
+  double tool_length_;
+  double rail_lower_;
+  double rail_upper_;
+};
+
+#endif  // ARIAC_EXAMPLE_ARM_KINEMATICS_H
@@ -0,0 +1,90 @@
+#ifndef ARIAC_EXAMPLE_COLLISION_MODEL_H
+#define ARIAC_EXAMPLE_COLLISION_MODEL_H
+
+#include <string>
+#include <vector>
+
+#include "ariac_example/arm_kinematics.h"
+#include "ariac_example/trajectory_timing.h"
+
+/*
+ * @brief Sphere model of the arm against box obstacles of the cell.
+ *
+ * Each arm link is covered by a row of overlapping spheres between two
+ * points of ArmKinematics::link_points(); the bins, AGV trays and conveyor
+ * are axis-aligned boxes. Sphere centres and box bounds are kept as
+ * structure-of-arrays, and the distance test is a branch-free loop over the
+ * spheres for each box so the compiler vectorises it.
+ *
+ * A segment between two joint configurations is checked by sampling it in
+ * joint space. route() adds tucked intermediate waypoints when the direct
+ * segment is blocked, replacing the hand-placed middle waypoints.
+ *
+ * Checks reuse scratch buffers, so one model serves one thread.
+ */
+class CollisionModel
+{
+public:
+  explicit CollisionModel(const ArmKinematics & kinematics);
+
+  void add_box(const std::string & name, const Vec3 & min, const Vec3 & max);
+
+  /*
+   * @brief Add the bins, AGV trays and conveyor of the ARIAC 2017 qual1a cell
+   *
+   * Placed from the world geometry rather than the waypoint table, so the
+   * table's motions are checked against the cell instead of fitted to it.
+   */
+  void add_ariac_cell();
+
+  /// Joint positions the arm tucks into when routing around obstacles.
+  void set_tuck(const JointPositions & tuck) { tuck_ = tuck; }
+
+  /// Largest joint step (rad, m for the rail) between checked samples of a segment.
+  void set_max_step(double step) { max_step_ = step; }
+
+  /// Whether the arm in configuration q is clear of every box.
+  bool free(const JointPositions & q) const;
+
+  /// Whether every sample on the straight joint-space segment from a to b is free.
+  bool segment_free(const JointPositions & a, const JointPositions & b) const;
+
+  /*
+   * @brief Find intermediate waypoints that make the move from one configuration to another free
+   * @param via: filled with up to two waypoints to pass through, in order
+   * @return how many waypoints were needed, or -1 if no route was found
+   */
+  int route(const JointPositions & from, const JointPositions & to, const TrajectoryTiming & timing,
+            JointPositions via[2]) const;
+
+  size_t spheres() const { return radius_.size(); }
+  size_t boxes() const { return box_min_x_.size(); }
+
+private:
+  /// Put the spheres of configuration q into the centre arrays.
+  void place_spheres(const JointPositions & q) const;
+
+  ArmKinematics kinematics_;
+  JointPositions tuck_;
+  double max_step_;
+
+  // Spheres: which link they sit on, where along it, and their radii.
+  std::vector<int> link_;
+  std::vector<double> along_;
+  std::vector<double> radius_;
+  std::vector<double> radius_sq_;
+  // Centres for the configuration being checked; scratch, reused.
+  mutable std::vector<double> x_;
+  mutable std::vector<double> y_;
+  mutable std::vector<double> z_;
+
+  std::vector<std::string> box_names_;
+  std::vector<double> box_min_x_;
+  std::vector<double> box_min_y_;
+  std::vector<double> box_min_z_;
+  std::vector<double> box_max_x_;
+  std::vector<double> box_max_y_;
+  std::vector<double> box_max_z_;
+};
+
+#endif  // ARIAC_EXAMPLE_COLLISION_MODEL_H
@@ -0,0 +1,403 @@
+#ifndef ARIAC_EXAMPLE_COMPETITION_H
+#define ARIAC_EXAMPLE_COMPETITION_H
+
+#include <atomic>
+#include <initializer_list>
+#include <map>
+#include <vector>
+#include <ros/ros.h>
+
+#include <osrf_gear/LogicalCameraImage.h>
+#include <osrf_gear/Order.h>
+#include <osrf_gear/Proximity.h>
+#include <sensor_msgs/JointState.h>
+#include <sensor_msgs/LaserScan.h>
+#include <sensor_msgs/Range.h>
+#include <std_msgs/Float32.h>
+#include <std_msgs/String.h>
+#include <trajectory_msgs/JointTrajectory.h>
+#include <osrf_gear/VacuumGripperState.h>
+#include <tf/transform_listener.h>
+
+#include "ariac_example/collision_model.h"
+#include "ariac_example/competition_config.h"
+#include "ariac_example/convergence.h"
+#include "ariac_example/conveyor_tracker.h"
+#include "ariac_example/event_log.h"
+#include "ariac_example/gripper_actuator.h"
+#include "ariac_example/ik_table.h"
+#include "ariac_example/instrumentation.h"
+#include "ariac_example/joint_index.h"
+#include "ariac_example/latest_value.h"
+#include "ariac_example/part_index.h"
+#include "ariac_example/startup_tracker.h"
+#include "ariac_example/task_engine.h"
+#include "ariac_example/task_state_machine.h"
+#include "ariac_example/throughput_dashboard.h"
+#include "ariac_example/tf_cache.h"
+#include "ariac_example/trajectory_builder.h"
+#include "ariac_example/transport.h"
+#include "ariac_example/tray_manager.h"
+#include "ariac_example/waypoint_table.h"
+
+/// Example class that can hold state and provide methods that handle incoming data.
+class MyCompetitionClass
+{
+public:
+  /*
+   * @param transport: where arm commands and gripper calls go
+   * @param config: tunables, see CompetitionConfig
+   */
+  MyCompetitionClass(Transport & transport, const CompetitionConfig & config);
+
+  /// Arm model with the base placement from the config, if any.
+  static ArmKinematics arm_kinematics(const CompetitionConfig & config);
+
+  /*
+   * @brief The CPU-heavy part of startup, safe to run on another thread before the first task
+   *
+   * Fills the IK table over the bins, trays and belt, and runs the pick
+   * planner once on a kit as large as it solves exactly, so the first order
+   * does not pay for either. Tasks wait until it is done.
+   */
+  void warm_up();
+
+  /// Whether the arm is at its ready pose with a fresh gripper transform, so a start call can be made.
+  bool ready_to_start() const {
+    return startup_.reached(StartupTracker::kArmReady) && startup_.reached(StartupTracker::kTfReady);
+  }
+
+  /// Record a startup milestone, once.
+  void milestone(StartupTracker::Milestone milestone);
+
+  /// When each step of startup was reached.
+  const StartupTracker & startup() const {
+    return startup_;
+  }
+
+  /// Feed a recorded transform when the TF cache is not listening to /tf itself.
+  void add_transform(const tf::StampedTransform & transform, bool is_static);
+
+  /// Number of pick/place tasks still queued, including the one in progress.
+  size_t pending_tasks() const {
+    return task_engine_.pending();
+  }
+
+  /// Kit state of the AGV trays, and orders completed so far.
+  const TrayManager & trays() const {
+    return trays_;
+  }
+
+  /// Callback, command and lookup timings recorded so far.
+  const Instrumentation & instrumentation() const {
+    return instrumentation_;
+  }
+
+  /// Called when a new message is received.
+  void current_score_callback(const std_msgs::Float32::ConstPtr & msg);
+
+  /// Called when a new message is received.
+  void competition_state_callback(const std_msgs::String::ConstPtr & msg);
+
+  /// Called when a new Order message is received.
+  void order_callback(const osrf_gear::Order::ConstPtr & order_msg);
+
+  /// Called when a new JointState message is received.
+  void joint_state_callback(const sensor_msgs::JointState::ConstPtr & joint_state_msg);
+
+  /// One iteration of the control loop, run at a fixed rate by the driver.
+  void control_tick();
+
+  /*
+   * @brief What has happened since the last tick, as TaskStates::Event bits
+   *
+   * A new joint state is also mapped onto the arm joints here, for the handlers.
+   */
+  uint32_t collect_events(const ros::Time & now);
+
+  /// What the cell is waiting on in the current state, for the dashboard.
+  ThroughputDashboard::Activity activity() const;
+
+  /// Score, parts and time use so far.
+  const ThroughputDashboard & dashboard() const {
+    return dashboard_;
+  }
+
+  /*
+   * @brief Save the dashboard time series to its file, once
+   *
+   * The control loop calls this when the competition is done; call it at
+   * shutdown too, for runs that end before that.
+   * @return false if the file could not be written
+   */
+  bool write_series();
+
+  /// Mark the arm and TF milestones of startup once they are reached.
+  void check_ready();
+
+  /// Time spent in each task state and on each transition so far.
+  const TaskStates & task_states() const {
+    return state_machine_;
+  }
+
+  // Handlers for state_machine_, one per state that acts on events. Each
+  // checks its guards, does the transition's actions and returns the next
+  // state, or kNoState to stay.
+
+  /// States that only group others, or wait on their parent's events.
+  template <TaskStates::State S>
+  TaskStates::State on(StateTag<S>) {
+    return TaskStates::kNoState;
+  }
+
+  /// The first joint state: send the arm to ready.
+  TaskStates::State on(StateTag<TaskStates::kStartup>);
+
+  /// Start on the next task once its tray is free.
+  TaskStates::State on(StateTag<TaskStates::kIdle>);
+
+  /// Turn the gripper on once it is over the part; give up on the pick after bin_move_timeout_.
+  TaskStates::State on(StateTag<TaskStates::kMoveToBin>);
+
+  /// Give up on the pick if the part has not attached after bin_grasp_timeout_; kPick handles the attach.
+  TaskStates::State on(StateTag<TaskStates::kGraspBin>);
+
+  /// Any pick: once the part is attached, carry it back over the pick approach point and on to the tray.
+  TaskStates::State on(StateTag<TaskStates::kPick>);
+
+  /*
+   * @brief Plan to meet the next suitable part on the belt and hover over the meeting point
+   *
+   * The arm waits over the point where the tracker says the part can first
+   * be met, then goes down so it arrives with the part, with the gripper on.
+   * If the part goes by without attaching, the next one is tried.
+   */
+  TaskStates::State on(StateTag<TaskStates::kWaitForPart>);
+
+  /// Go down in time to arrive with the part.
+  TaskStates::State on(StateTag<TaskStates::kHoverOverBelt>);
+
+  /// Still not attached once the part has gone by: try the next one.
+  TaskStates::State on(StateTag<TaskStates::kMeetPart>);
+
+  /// Release over the tray; a part lost on the way is picked again.
+  TaskStates::State on(StateTag<TaskStates::kMoveToTray>);
+
+  /// The part is on the tray and the gripper is off; start on the next one.
+  TaskStates::State on(StateTag<TaskStates::kRelease>);
+
+  /// Create a JointTrajectory to the ready position, and command the arm.
+  void send_arm_to_zero_state();
+
+  /// Called when a new LogicalCameraImage message is received.
+  void logical_camera_callback(const osrf_gear::LogicalCameraImage::ConstPtr & image_msg);
+
+  /// Called when a new LogicalCameraImage message is received from the camera above the tray.
+  void tray_logical_camera_callback(const osrf_gear::LogicalCameraImage::ConstPtr & image_msg);
+
+  /*
+   * @brief Send the arm through all waypoints with a single trajectory command
+   * @param destination: what the move is for, for the event log
+   * @param waypoints: points to pass through; the last one is the goal
+   */
+  void move_to(const char * destination, std::initializer_list<const JointPositions *> waypoints);
+
+  /// Record the command-to-motion latency once the arm has left the position it was commanded from.
+  void record_motion_start();
+
+  /*
+   * @brief Route each leg of a move around the cell's obstacles
+   *
+   * Legs that are clear go straight through; blocked ones get tucked
+   * intermediate waypoints from the collision model. A leg with no clear
+   * route is sent as is, with a warning.
+   * @return the waypoints to send, in route_ and via_ (no allocation)
+   */
+  const std::vector<const JointPositions *> & route(
+    const char * destination, std::initializer_list<const JointPositions *> waypoints);
+
+  /// Publish the timing histograms on /diagnostics every diagnostics_period_ seconds.
+  void publish_diagnostics();
+
+  /// Whether the arm has reached a goal, using the latest joint positions and velocities.
+  bool arm_reached(const JointPositions & goal) const;
+
+  /// Called when a new Proximity message is received.
+  void break_beam_callback(const osrf_gear::Proximity::ConstPtr & msg);
+
+  /// Called when a new Range message is received.
+  void proximity_sensor_callback(const sensor_msgs::Range::ConstPtr & msg);
+
+  /// Called when a new LaserScan message is received.
+  void laser_profiler_callback(const sensor_msgs::LaserScan::ConstPtr & msg);
+
+  /// Called when a new VacuumGripperState message is received.
+  void gripper_state_attatch_callback(const osrf_gear::VacuumGripperState::ConstPtr & msg);
+
+  /*
+   * @brief This function is to enable the vacuum gripper to grasp kit
+   */
+  void grasp_kit();
+
+  /*
+   * @brief This function is to disable the vacuum gripper to release the kit
+   */
+  void release_kit();
+
+  /*
+   * @brief Check whether relative position under tolerance with difference upper and lower bound
+   * @param upper_bound: the upper_bound of tolerance
+   * @param lower_bound: the lower bound of tolerance
+   * @param relative_pose: relative position in x, y, z direction
+   * @return bool
+   */
+  bool under_tolerance(const geometry_msgs::Point& upper_bound,
+    const geometry_msgs::Point& lower_bound, const geometry_msgs::Point& relative_pose);
+
+  /*
+   * @brief Check whether relative positions under tolerance
+   * @param tolerance: tolerance in x, y, z direction;
+   * @param relative_pose: relative position in x, y, z direction
+   * @return bool
+   */
+  bool under_tolerance(const geometry_msgs::Point& tolerance, const geometry_msgs::Point& relative_pose);
+
+  /// tf_cache_.lookup_origin(), timed; a failure is kept in tf_missing_ for the dashboard.
+  bool lookup_origin(int pair, geometry_msgs::Point & origin);
+
+  /*
+   * @brief Look up where the gripper is relative to a registered frame and compare with a tolerance
+   * @param pair: frame pair handle from tf_cache_
+   * @param tolerance: tolerance in x, y, z direction
+   * @return false if the gripper is outside the tolerance or the transform is not fresh
+   */
+  bool gripper_near(int pair, const geometry_msgs::Point& tolerance);
+
+  /*
+   * @brief Gripper Control: Enable Gripper when it closes the bin
+   * @param bin: bin number the part is picked from
+   * @return whether the gripper was turned on
+   */
+  bool grasp_bin(int bin);
+
+  /*
+   * @brief With ik_picks_, pick the part of the current task's type closest to the bin grasp point
+   *
+   * The search is centred where the bin waypoints put the gripper, not where
+   * the arm happens to be. A part found is picked with IK over it; otherwise
+   * the bin waypoints are kept and grasp_bin() checks the bin frame.
+   */
+  void find_target_part();
+
+  /*
+   * @brief Whether the part being met has gone by without attaching
+   *
+   * If so the gripper is turned off and the part forgotten, and the next one
+   * is looked for on the next tick.
+   */
+  bool missed_conveyor_part(const ros::Time & now);
+
+  /// Whether a timeout is set and this long has passed since the state was entered.
+  bool timed_out(TaskStates::State state, double timeout, const ros::Time & now) const;
+
+  /*
+   * @brief Give up on a bin pick that timed out, as a timeout transition to idle
+   *
+   * The gripper is turned off. The task is started again from idle, which
+   * locates and plans the pick afresh, up to pick_retries_ times; after that
+   * its part is skipped and the kit finished without it.
+   */
+  TaskStates::State retry_pick(const ros::Time & now);
+
+  /// Sensor stamp, or the time of arrival for unstamped messages.
+  static ros::Time stamp_or_now(const ros::Time & stamp);
+
+  /*
+   * @brief Replace the task's hand-tuned pick waypoints with IK solutions over the target part
+   * @return false if either point could not be solved; the task is left as it was
+   */
+  bool plan_pick();
+
+  /*
+   * @brief Gripper Control: Disable Gripper when it closes the tray
+   * @param agv: AGV whose tray the part is placed on
+   * @return whether the gripper was turned off
+   */
+  bool place_kit_tray(int agv);
+
+private:
+  std::string competition_state_;
+  std::atomic<bool> competition_done_{false};  ///< set by the callback, acted on by the control loop
+  double current_score_;
+  Instrumentation instrumentation_;
+  InstrumentedTransport transport_;  ///< every outgoing command goes through here, timed
+  double diagnostics_period_;        ///< seconds; 0 disables publishing
+  ros::Time last_diagnostics_;
+  diagnostic_msgs::DiagnosticArray diagnostics_;
+  LatestValue<sensor_msgs::JointState> current_joint_states_;
+  TaskStateMachine<MyCompetitionClass> state_machine_;
+  // What collect_events() saw last, to tell what is new.
+  sensor_msgs::JointState::ConstPtr last_joint_state_;
+  bool was_attached_ = false;
+  bool was_confirmed_ = false;
+  size_t last_pending_ = 0;
+  size_t last_tray_changes_ = 0;
+  size_t last_kits_submitted_ = 0;
+  size_t last_conveyor_fixes_ = 0;
+  std::atomic<bool> gripper_state_attatch_{false};
+  GripperActuator gripper_;
+  TfCache tf_cache_;
+  EventLog events_;
+  StartupTracker startup_;
+  std::atomic<bool> warm_{false};  ///< warm_up() has finished
+  std::map<int, int> bin_frames_;   ///< bin number -> tf_cache_ frame pair
+  std::map<int, int> tray_frames_;  ///< agv number -> tf_cache_ frame pair
+  int world_frames_;                ///< gripper in the world frame
+  bool tf_missing_ = false;         ///< the last lookup_origin() found no fresh transform
+  PartIndex part_index_;
+  IndexedPart target_part_;
+  bool has_target_part_ = false;  ///< task_.pick was planned over target_part_
+  double part_reach_;
+  geometry_msgs::Point bin_tolerance_;
+  geometry_msgs::Point tray_tolerance_;
+  WaypointTable waypoint_table_;
+  std::vector<int> bins_;  ///< bins picked from, not counting the conveyor
+  std::vector<int> agvs_;
+  bool conveyor_picks_ = false;
+  size_t warm_up_parts_;   ///< kit size the planner is warmed up on
+  TaskEngine task_engine_;
+  PickPlaceTask task_;
+  TrajectoryBuilder trajectory_builder_;
+  JointIndex joint_index_;
+  JointPositions current_positions_;  ///< arm joints from the latest joint state
+  JointPositions current_velocities_;
+  bool has_velocities_ = false;
+  ConvergenceCheck convergence_;
+  IkTable ik_table_;
+  bool ik_picks_;
+  double pick_approach_height_;
+  double pick_grasp_height_;
+  double bin_move_timeout_;
+  double bin_grasp_timeout_;
+  int pick_retries_;
+  int pick_attempts_ = 0;  ///< timed-out attempts at the current task's pick
+  CollisionModel collision_model_;
+  bool check_collisions_;
+  static const size_t kMaxRouteWaypoints = 8;
+  JointPositions via_[kMaxRouteWaypoints];  ///< intermediate waypoints added by route()
+  std::vector<const JointPositions *> route_;
+  ConveyorTracker conveyor_;
+  ConveyorIntercept intercept_;  ///< part the current conveyor pick is meeting
+  bool conveyor_untyped_;
+  double conveyor_lead_time_;
+  TrayManager trays_;
+  int tray_camera_agv_;  ///< AGV whose tray logical_camera_2 watches, 0 for none
+  ThroughputDashboard dashboard_;
+  std::string dashboard_file_;  ///< time series file, empty for none
+  bool series_written_ = false;
+  JointPositions command_start_;  ///< where the arm was when the last command was sent
+  ros::Time command_stamp_;
+  bool awaiting_motion_ = false;
+};
+
+#endif  // ARIAC_EXAMPLE_COMPETITION_H
@@ -0,0 +1,62 @@
+#ifndef ARIAC_EXAMPLE_COMPETITION_CONFIG_H
+#define ARIAC_EXAMPLE_COMPETITION_CONFIG_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <ros/ros.h>
+
+/*
+ * @brief Tunables of MyCompetitionClass.
+ *
+ * The defaults are what the node runs with when no private parameters are
+ * set; load() overrides them from the parameter server. The replay driver
+ * uses the defaults without needing a ROS master.
+ */
+struct CompetitionConfig {
+  CompetitionConfig();
+
+  /// Override the defaults from private parameters (~part_bins, ~tf_max_age, ...).
+  void load(const ros::NodeHandle & private_node);
+
+  std::map<std::string, int> part_bins;  ///< part type -> bin it is picked from
+  double tf_max_age;                     ///< seconds before a cached transform is stale
+  double part_reach;                     ///< metres from the bin grasp point to look for parts
+  double limit_scale;                    ///< fraction of the joint limits used
+  double min_segment_time;               ///< seconds
+  std::vector<double> max_joint_velocity;      ///< empty: TrajectoryTiming defaults
+  std::vector<double> max_joint_acceleration;  ///< empty: TrajectoryTiming defaults
+  std::vector<double> goal_tolerance;          ///< empty: ConvergenceCheck defaults
+  double settle_velocity;                ///< 0 disables the velocity condition
+  double gripper_timeout;                ///< seconds to wait for the gripper state
+  bool listen_tf;                        ///< subscribe to /tf, or be fed transforms
+  bool gripper_worker;                   ///< call the gripper and AGV services from worker threads
+  double diagnostics_period;             ///< seconds between timing reports, 0 disables them
+  std::string metrics_file;              ///< timing table written at shutdown, empty for none
+  std::string event_log_file;            ///< binary event log, empty for none
+  bool event_console;                    ///< print events through rosconsole
+  std::vector<double> arm_base;          ///< x, y, z, yaw of the arm base at rail 0; empty: ArmKinematics default
+  double ik_resolution;                  ///< metres between IK table cells
+  bool ik_picks;                         ///< pick located parts with IK instead of the hand-tuned grasp
+  double pick_approach_height;           ///< metres above the part for the approach point
+  double pick_grasp_height;              ///< metres above the part origin to grasp at
+  double bin_move_timeout;               ///< seconds to get over a bin part before the pick is tried again, 0: none
+  double bin_grasp_timeout;              ///< seconds for a bin part to attach before the pick is tried again, 0: none
+  int pick_retries;                      ///< times a timed-out bin pick is planned again before its part is skipped
+  double plan_time_budget;               ///< seconds the pick planner may spend per kit
+  int plan_exact_limit;                  ///< largest kit ordered exactly rather than heuristically
+  bool check_collisions;                 ///< route arm commands around the bins, trays and conveyor
+  /// name -> [min x, min y, min z, max x, max y, max z] of a box in the world frame; empty: the ARIAC 2017 cell
+  std::map<std::string, std::vector<double> > obstacles;
+  std::vector<double> conveyor_pick_window;  ///< [min_y, max_y] of belt picks; empty: ConveyorTracker default
+  bool conveyor_untyped;                 ///< meet belt parts no camera has named yet
+  double conveyor_lead_time;             ///< seconds of slack when meeting a belt part
+  std::vector<int> agvs;                 ///< AGVs kits are built on, in turn; AGV 1 only by default
+  double agv_transit_time;               ///< seconds from submitting a tray to it being back
+  int tray_camera_agv;                   ///< AGV whose tray logical_camera_2 watches, 0 for none
+  std::string dashboard_file;            ///< throughput time series written when done, empty for none
+  double dashboard_period;               ///< seconds between time series samples
+  int dashboard_samples;                 ///< time series rows kept; past that the oldest are dropped
+};
+
+#endif  // ARIAC_EXAMPLE_COMPETITION_CONFIG_H
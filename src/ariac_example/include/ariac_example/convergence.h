@@ -0,0 +1,52 @@
+#ifndef ARIAC_EXAMPLE_CONVERGENCE_H
+#define ARIAC_EXAMPLE_CONVERGENCE_H
+
+#include <vector>
+
+#include "ariac_example/joint_index.h"
+
+/*
+ * @brief Decides when the arm has reached a goal configuration.
+ *
+ * Each joint has its own position tolerance (the rail is measured in metres,
+ * the rest in radians), and the arm can optionally be required to have
+ * settled, i.e. every joint speed below a limit. Both checks run over the
+ * fixed seven-joint layout with no early exit, so the compiler can keep
+ * them branch-free.
+ */
+class ConvergenceCheck
+{
+public:
+  /// 0.05 on every joint, no velocity condition.
+  ConvergenceCheck();
+
+  /*
+   * @brief Set the position tolerance of every joint
+   * @return false, leaving the tolerances unchanged, if any is not positive
+   */
+  bool set_position_tolerance(const std::vector<double> & tolerance);
+
+  /// Require every joint speed to be below max_speed; zero disables the condition.
+  void set_settle_velocity(double max_speed) { settle_velocity_ = max_speed; }
+
+  bool uses_velocity() const { return settle_velocity_ > 0.0; }
+
+  /// Whether every joint is within its tolerance of the goal.
+  bool converged(const JointPositions & goal, const JointPositions & position) const;
+
+  /// Whether every joint speed is below the settle velocity.
+  bool settled(const JointPositions & velocity) const;
+
+  /*
+   * @brief Full check: converged, and settled if the velocity condition is on
+   * @param velocity: joint speeds, or null if the joint state carries none
+   */
+  bool reached(const JointPositions & goal, const JointPositions & position,
+               const JointPositions * velocity) const;
+
+private:
+  JointPositions tolerance_;
+  double settle_velocity_;
+};
+
+#endif  // ARIAC_EXAMPLE_CONVERGENCE_H
@@ -0,0 +1,171 @@
+#ifndef ARIAC_EXAMPLE_CONVEYOR_TRACKER_H
+#define ARIAC_EXAMPLE_CONVEYOR_TRACKER_H
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <osrf_gear/LogicalCameraImage.h>
+#include <ros/ros.h>
+#include <sensor_msgs/LaserScan.h>
+
+#include "ariac_example/arm_kinematics.h"
+
+/// A part riding the conveyor, as last fixed by one of the sensors.
+struct ConveyorPart {
+  int id;
+  std::string type;  ///< empty until a logical camera names it
+  int sensor;        ///< ConveyorTracker::Sensor that last fixed it
+  ros::Time stamp;   ///< when it was last fixed
+  double y;          ///< world y of the part's centre at `stamp`
+  double x;          ///< world x across the belt
+  double height;     ///< top face above the belt, 0 if the laser did not profile it
+  double length;     ///< along the belt, 0 if the laser did not profile it
+};
+
+/// Where and when the gripper can meet a part on the belt.
+struct ConveyorIntercept {
+  int part;        ///< ConveyorPart::id
+  ros::Time time;  ///< when the part's centre is under `position`
+  Vec3 position;   ///< world position of the part's top face at `time` (estimated if not profiled)
+};
+
+/*
+ * @brief Tracks parts along the conveyor from the belt sensors.
+ *
+ * Parts enter when the laser profiler first sees them, or at whichever
+ * sensor sees them first. Every later sensor crossing is matched to the
+ * part predicted nearest to that sensor, fixes its position again and gives
+ * a belt speed sample; logical camera frames that cover the belt name the
+ * part and fix it too. Parts are kept in a fixed pool and dropped once they
+ * run off the end of the belt.
+ *
+ * Each laser scan is reduced in one branch-free pass over `ranges`, against
+ * per-ray cos/sin tables built on the first scan, so scans allocate nothing.
+ * The scan plane is taken to be across the belt with angle 0 pointing down.
+ *
+ * Safe to feed from the sensor threads while the control loop queries it.
+ */
+class ConveyorTracker
+{
+public:
+  enum Sensor {
+    kLaserProfiler,
+    kProximity,
+    kBreakBeam,
+    kCamera,
+    kNumSensors
+  };
+
+  static const size_t kMaxParts = 16;
+
+  /// Sensor placement from team_conf.yaml, belt running towards -y at 0.2 m/s.
+  ConveyorTracker();
+
+  /// World y of a sensor along the belt.
+  void set_sensor_y(Sensor sensor, double y);
+
+  /*
+   * @brief Place the belt
+   * @param x: world x of the belt centre line
+   * @param top: world z of the belt surface
+   * @param direction: +1 if parts move towards +y, -1 towards -y
+   * @param end_y: world y where parts leave the belt
+   */
+  void set_belt(double x, double top, double direction, double end_y);
+
+  /// Stretch of belt (world y) the arm can pick from.
+  void set_pick_window(double min_y, double max_y);
+  double pick_min_y() const { return pick_min_y_; }
+  double pick_max_y() const { return pick_max_y_; }
+
+  /// Laser profiler height, for turning ranges into heights above the belt.
+  void set_laser_height(double z) { laser_z_ = z; }
+
+  void laser_scan(const ros::Time & stamp, const sensor_msgs::LaserScan & scan);
+  void proximity(const ros::Time & stamp, bool detected);
+  void break_beam(const ros::Time & stamp, bool detected);
+
+  /// Merge the parts of a logical camera frame that lie on the belt.
+  void camera(const osrf_gear::LogicalCameraImage & image, const ros::Time & stamp);
+
+  /// Estimated belt speed, m/s.
+  double speed() const;
+
+  /// Copy a tracked part; false if it is no longer tracked.
+  bool part(int id, ConveyorPart & part) const;
+
+  /*
+   * @brief Earliest point in the pick window where the gripper can meet a part
+   * @param type: part type wanted; parts not yet named match too if accept_untyped
+   * @param ready: earliest time the gripper can be over the belt
+   * @param margin: seconds to keep between the intercept and the part leaving the window
+   * @return false if no tracked part can be met in the window
+   */
+  bool intercept(const std::string & type, bool accept_untyped, const ros::Time & ready, double margin,
+                 ConveyorIntercept & intercept) const;
+
+  /// Stop tracking a part, e.g. once it has been picked.
+  void remove(int id);
+
+  size_t tracked() const;
+
+  /// Sensor fixes so far; a new value means some part was seen again.
+  size_t fixes() const;
+
+private:
+  struct Profile {
+    float hits;
+    float top;     ///< smallest drop below the laser among the hits
+    float lower;   ///< lateral extent of the hits
+    float upper;
+  };
+
+  /// Rising edge at a point sensor: match it to a part and fix the part there.
+  int crossing(Sensor sensor, const ros::Time & stamp);
+
+  /// Part predicted nearest to y at stamp among those last fixed upstream of it; -1 for none.
+  int match(double y, const ros::Time & stamp, double max_distance, bool upstream_only) const;
+
+  /// Fix part i at y, taking a belt speed sample from the move since its last fix.
+  void fix(size_t i, Sensor sensor, double y, const ros::Time & stamp);
+
+  /// Take a free slot, dropping the oldest part if the pool is full.
+  size_t add(Sensor sensor, double y, const ros::Time & stamp);
+
+  /// Drop parts predicted past the end of the belt.
+  void expire(const ros::Time & stamp);
+
+  /// Position of part i's centre along the belt direction at a time.
+  double travelled(size_t i, const ros::Time & stamp) const;
+
+  std::array<double, kNumSensors> sensor_y_;
+  double belt_x_;
+  double belt_top_;
+  double direction_;
+  double end_y_;
+  double pick_min_y_;
+  double pick_max_y_;
+  double laser_z_;
+  double speed_;
+
+  std::array<ConveyorPart, kMaxParts> parts_;
+  std::array<bool, kMaxParts> used_;
+  int next_id_;
+  size_t fixes_;
+
+  // Laser state: the part under the profiler, and per-ray tables.
+  int laser_part_;
+  ros::Time laser_start_;
+  std::vector<float> ray_cos_;
+  std::vector<float> ray_sin_;
+  float ray_angle_min_;
+  float ray_increment_;
+  bool proximity_detected_;
+  bool break_beam_detected_;
+
+  mutable std::mutex mutex_;
+};
+
+#endif  // ARIAC_EXAMPLE_CONVEYOR_TRACKER_H
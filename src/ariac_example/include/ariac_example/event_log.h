@@ -0,0 +1,126 @@
+#ifndef ARIAC_EXAMPLE_EVENT_LOG_H
+#define ARIAC_EXAMPLE_EVENT_LOG_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <ros/ros.h>
+
+/*
+ * @brief Fixed-size record of one thing that happened.
+ *
+ * What the fields mean depends on the type; EventLog::format() is the one
+ * place that knows. The record is written to the log file as is.
+ */
+struct Event {
+  uint64_t stamp_ns;     ///< ros::Time when it was logged
+  uint16_t type;         ///< EventLog::Type
+  uint16_t reserved;
+  int32_t ints[3];
+  double values[3];
+  char text[40];         ///< NUL-terminated, truncated
+};
+
+/*
+ * @brief Structured event log that keeps formatting and I/O off the callers.
+ *
+ * log() copies a few fields into a bounded lock-free ring and returns; a
+ * background thread drains the ring, prints each event through rosconsole
+ * and appends the raw record to the log file, if one is open. When the ring
+ * is full the event is dropped and counted rather than waiting.
+ *
+ * Each type has a minimum interval between logged events, so a sensor that
+ * fires every frame cannot flood the log. The file is decoded offline with
+ * the ariac_example_events tool.
+ */
+class EventLog
+{
+public:
+  enum Type {
+    kScore,              ///< values[0]: score
+    kCompetitionState,   ///< text: state
+    kOrder,              ///< text: order id, ints: kits, tasks queued; values: planned and listed-order seconds
+    kJointState,         ///< ints[0]: joints in the message
+    kTrayCamera,         ///< ints: models seen, parts among them
+    kBreakBeam,
+    kProximity,
+    kLaserProfiler,      ///< ints[0]: parts tracked on the conveyor, values[0]: belt speed
+    kTaskStarted,        ///< text: part type, ints: bin, agv, tray slot
+    kTargetPart,         ///< text: part type, ints: bin, found; values: x, y
+    kArmCommand,         ///< text: destination, ints[0]: points, values[0]: planned seconds
+    kConveyorPick,       ///< text: part type, ints: part id, planned (1) or missed (0); values: s to intercept, y
+    kStateChange,        ///< text: new state, ints: state numbers from, to, timed out; values[0]: seconds in from
+    kStartup,            ///< text: StartupTracker milestone
+    kNumTypes
+  };
+
+  /*
+   * @param capacity: events the ring holds, rounded up to a power of two
+   * @param console: print drained events through rosconsole
+   */
+  explicit EventLog(size_t capacity = 1024, bool console = true);
+  ~EventLog();
+
+  /// Also append every drained event to a binary log file; false if it cannot be opened.
+  bool open(const std::string & path);
+
+  /// Minimum seconds between two logged events of a type; 0 logs every one.
+  void set_rate_limit(Type type, double seconds);
+
+  /// Queue an event; false if it was rate limited or the ring was full.
+  bool log(Type type, const char * text, int32_t a = 0, int32_t b = 0, int32_t c = 0,
+           double x = 0.0, double y = 0.0, double z = 0.0);
+
+  /// Events lost to a full ring so far.
+  uint64_t dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  /// Names a state number of a kStateChange event.
+  typedef const char * (*StateNames)(int state);
+
+  /// How to name the states of kStateChange events when printing them; by default they are numbers.
+  void set_state_names(StateNames names) {
+    state_names_.store(names);
+  }
+
+  /// Human-readable form of an event, without the timestamp.
+  static void format(const Event & event, std::ostream & out, StateNames state_names = NULL);
+
+  /// The file header; read_header() checks it and fails on a foreign or outdated file.
+  static void write_header(std::ostream & out);
+  static bool read_header(std::istream & in);
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    Event event;
+  };
+
+  bool push(const Event & event);
+  bool pop(Event & event);
+  void run();
+  void drain();
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  std::atomic<size_t> enqueue_pos_;
+  size_t dequeue_pos_;   ///< only touched by the drain thread
+  std::array<std::atomic<uint64_t>, kNumTypes> min_interval_ns_;
+  std::array<std::atomic<uint64_t>, kNumTypes> next_allowed_ns_;
+  std::atomic<uint64_t> dropped_;
+  uint64_t reported_dropped_;
+  bool console_;
+  std::atomic<StateNames> state_names_;
+  std::ofstream file_;
+  std::atomic<bool> running_;
+  std::thread worker_;
+};
+
+#endif  // ARIAC_EXAMPLE_EVENT_LOG_H
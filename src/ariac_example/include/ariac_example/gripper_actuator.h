@@ -0,0 +1,73 @@
+#ifndef ARIAC_EXAMPLE_GRIPPER_ACTUATOR_H
+#define ARIAC_EXAMPLE_GRIPPER_ACTUATOR_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <ros/ros.h>
+#include <osrf_gear/VacuumGripperState.h>
+
+#include "ariac_example/transport.h"
+
+/*
+ * @brief Non-blocking vacuum gripper control.
+ *
+ * request() only records the wanted state and returns; a worker thread makes
+ * the /ariac/gripper/control service call. Asking for the state that is
+ * already wanted is a no-op, so the control loop can call request() every
+ * tick. A request counts as done once /ariac/gripper/state reports the
+ * gripper enabled (or disabled); if that does not happen within the timeout
+ * the call is made again.
+ *
+ * Without the worker (offline replay) the call is made inline by request(),
+ * which keeps the run deterministic. A failed inline call stays pending, and
+ * update() makes it again once the timeout has passed.
+ */
+class GripperActuator
+{
+public:
+  /*
+   * @param transport: makes the /ariac/gripper/control calls
+   * @param use_worker: call from a worker thread, or inline from request()
+   */
+  explicit GripperActuator(Transport & transport, bool use_worker = true,
+                           const ros::Duration & timeout = ros::Duration(1.0));
+  ~GripperActuator();
+
+  void set_timeout(const ros::Duration & timeout);
+
+  /// Ask for the gripper to be enabled or disabled; returns immediately.
+  void request(bool enable);
+
+  /// Without the worker, retry a failed call once the timeout has passed; call every tick.
+  void update(const ros::Time & now);
+
+  /// Feed the latest /ariac/gripper/state message.
+  void on_state(const osrf_gear::VacuumGripperState & state);
+
+  /// Whether the gripper state matches the last request.
+  bool confirmed() const;
+
+  /// Whether the gripper is holding a part, as last reported.
+  bool attached() const;
+
+private:
+  void run();
+  bool call(bool enable);
+  /// Send desired_ from the calling thread; lock is held on entry and on return.
+  void call_inline(std::unique_lock<std::mutex> & lock);
+
+  Transport & transport_;
+  double timeout_;          ///< seconds to wait for the state to confirm a call
+  bool desired_;            ///< last requested state
+  bool call_pending_;       ///< desired_ still has to be sent to the service
+  bool enabled_;            ///< last reported state
+  bool attached_;
+  bool running_;
+  ros::Time retry_at_;      ///< without the worker: when to retry a failed call
+  mutable std::mutex mutex_;
+  std::condition_variable changed_;
+  std::thread worker_;
+};
+
+#endif  // ARIAC_EXAMPLE_GRIPPER_ACTUATOR_H
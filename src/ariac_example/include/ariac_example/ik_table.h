@@ -0,0 +1,97 @@
+#ifndef ARIAC_EXAMPLE_IK_TABLE_H
+#define ARIAC_EXAMPLE_IK_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ariac_example/arm_kinematics.h"
+#include "ariac_example/waypoint_table.h"
+
+/*
+ * @brief Precomputed inverse kinematics over the bin and AGV workspaces.
+ *
+ * Each region is a box of gripper positions sampled on a regular grid. The
+ * grid is filled once, at startup, by walking it cell to cell and refining
+ * each cell from its neighbour's solution, starting from a hand-tuned joint
+ * configuration, so neighbouring cells hold neighbouring solutions on the
+ * same IK branch. Solutions are stored contiguously per region.
+ *
+ * solve() seeds from the nearest cell and refines for a few iterations,
+ * which is all a target inside a region needs.
+ */
+class IkTable
+{
+public:
+  /*
+   * @param kinematics: arm model, copied
+   * @param resolution: grid spacing in metres
+   */
+  explicit IkTable(const ArmKinematics & kinematics, double resolution = 0.05);
+
+  /*
+   * @brief Add a region and fill its grid
+   * @param name: for logging
+   * @param min, max: corners of the box of gripper positions
+   * @param seed: joint configuration with the gripper near the box, pointing down
+   * @return number of cells that converged
+   */
+  size_t add_region(const std::string & name, const Vec3 & min, const Vec3 & max,
+                    const JointPositions & seed);
+
+  /// add_region() with a box of half_extent around where seed puts the gripper.
+  size_t add_region_around(const std::string & name, const JointPositions & seed,
+                           const Vec3 & half_extent);
+
+  /*
+   * @brief Add a region around the first grasp of each bin and the first place goal of each AGV
+   * @param table: hand-tuned waypoints, used as the seeds
+   * @param half_extent: half size of each region box
+   * @return number of cells that converged
+   */
+  size_t add_regions(const WaypointTable & table, const std::vector<int> & bins,
+                     const std::vector<int> & agvs, const Vec3 & half_extent);
+
+  /*
+   * @brief Table solution nearest to a gripper position
+   * @return false if there are no regions
+   */
+  bool seed(const Vec3 & target, JointPositions & q) const;
+
+  /*
+   * @brief Solve for a gripper position, pointing down
+   * @param error: if set, the remaining position error in metres
+   * @return false if refining from the table seed did not converge
+   */
+  bool solve(const Vec3 & target, JointPositions & q, double * error = NULL) const;
+
+  const ArmKinematics & kinematics() const { return kinematics_; }
+
+  /// Cells in all regions, and how many of them converged.
+  size_t size() const { return solutions_.size(); }
+  size_t valid() const;
+
+  static const int kRefineIterations = 8;
+  static const int kBuildIterations = 50;
+  static constexpr double kTolerance = 1e-4;
+
+private:
+  struct Region {
+    std::string name;
+    Vec3 min;
+    Vec3 max;
+    size_t cells[3];
+    size_t offset;  ///< first cell in solutions_
+  };
+
+  const Region * nearest_region(const Vec3 & target) const;
+  size_t cell_index(const Region & region, const Vec3 & target) const;
+
+  ArmKinematics kinematics_;
+  double resolution_;
+  std::vector<Region> regions_;
+  std::vector<JointPositions> solutions_;
+  std::vector<uint8_t> converged_;
+};
+
+#endif  // ARIAC_EXAMPLE_IK_TABLE_H
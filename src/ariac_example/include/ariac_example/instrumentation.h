@@ -0,0 +1,164 @@
+#ifndef ARIAC_EXAMPLE_INSTRUMENTATION_H
+#define ARIAC_EXAMPLE_INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <ros/ros.h>
+#include <diagnostic_msgs/DiagnosticArray.h>
+
+#include "ariac_example/transport.h"
+
+/*
+ * @brief Latency histogram that can be recorded into from any thread.
+ *
+ * Bucket i counts durations in [2^(i-1), 2^i) microseconds (bucket 0 is
+ * everything under 1 us), so recording is an index computation and a few
+ * relaxed atomic increments: no locks and no allocation. Instrumentation
+ * keeps one per thread, so the increments are not contended.
+ */
+class LatencyHistogram
+{
+public:
+  static const size_t kBuckets = 32;
+
+  /// A consistent-enough copy of the counters for reporting.
+  struct Snapshot {
+    uint64_t count;
+    uint64_t total_us;
+    uint64_t max_us;
+    std::array<uint64_t, kBuckets> buckets;
+
+    double mean_ms() const;
+    /// Upper bound of the bucket holding the p-th quantile (0 <= p <= 1), in ms.
+    double percentile_ms(double p) const;
+    /// Add another thread's counts to these.
+    void merge(const Snapshot & other);
+  };
+
+  LatencyHistogram();
+
+  void record(double seconds);
+  Snapshot snapshot() const;
+
+private:
+  std::array<std::atomic<uint64_t>, kBuckets> buckets_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> total_us_;
+  std::atomic<uint64_t> max_us_;
+};
+
+/*
+ * @brief Always-on timing of callbacks and outgoing commands.
+ *
+ * One histogram per probe, indexed by the Probe enum so recording never
+ * looks anything up. Callback durations are wall time; message ages and
+ * command-to-motion latency are in ros::Time, so they also make sense when
+ * replaying a bag.
+ *
+ * Each thread records into a set of histograms of its own, on its own cache
+ * lines, and reports merge the sets. Threads are given sets in the order
+ * they first record; past kThreadSlots they share them, which stays correct
+ * since the counters are atomic.
+ */
+class Instrumentation
+{
+public:
+  enum Probe {
+    kCurrentScoreCallback,
+    kCompetitionStateCallback,
+    kOrderCallback,
+    kJointStateCallback,
+    kLogicalCameraCallback,
+    kTrayLogicalCameraCallback,
+    kBreakBeamCallback,
+    kProximitySensorCallback,
+    kLaserProfilerCallback,
+    kGripperStateCallback,
+    kControlTick,
+    kJointStateAge,       ///< header stamp to callback
+    kSensorAge,           ///< header stamp to callback, proximity and laser
+    kArmCommandPublish,
+    kCommandToMotion,     ///< arm command sent to the joints first moving
+    kTfLookup,
+    kGripperCall,
+    kCollisionCheck,      ///< routing an arm command around obstacles
+    kAgvCall,
+    kWarmUp,              ///< IK table fill and planner warm-up at startup
+    kTimeToFirstCommand,  ///< competition start to the first arm command for a task
+    kNumProbes
+  };
+
+  static const char * name(Probe probe);
+
+  static const size_t kThreadSlots = 16;
+
+  void record(Probe probe, double seconds) {
+    slots_[thread_slot()].histograms[probe].record(seconds);
+  }
+
+  /// Record the age of a message stamped at `stamp`; unstamped messages are skipped.
+  void record_age(Probe probe, const ros::Time & stamp);
+
+  /// The probe's counts over every thread.
+  LatencyHistogram::Snapshot snapshot(Probe probe) const;
+
+  /// One DiagnosticStatus per probe that has recorded anything.
+  void fill(diagnostic_msgs::DiagnosticArray & diagnostics) const;
+
+  /// Plain-text table of every probe that has recorded anything.
+  void write(std::ostream & out) const;
+
+private:
+  struct alignas(64) Slot {
+    std::array<LatencyHistogram, kNumProbes> histograms;
+  };
+
+  /// The calling thread's slot, the same in every Instrumentation.
+  static size_t thread_slot();
+
+  std::array<Slot, kThreadSlots> slots_;
+};
+
+/// Records the wall time spent in its scope into one probe.
+class ScopedTimer
+{
+public:
+  ScopedTimer(Instrumentation & instrumentation, Instrumentation::Probe probe)
+  : instrumentation_(instrumentation), probe_(probe), start_(std::chrono::steady_clock::now())
+  {
+  }
+
+  ~ScopedTimer() {
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+    instrumentation_.record(probe_, elapsed.count());
+  }
+
+private:
+  Instrumentation & instrumentation_;
+  Instrumentation::Probe probe_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+/// Transport decorator timing the arm command publish and the gripper service call.
+class InstrumentedTransport : public Transport
+{
+public:
+  InstrumentedTransport(Transport & transport, Instrumentation & instrumentation)
+  : transport_(transport), instrumentation_(instrumentation)
+  {
+  }
+
+  void publish_arm_command(const trajectory_msgs::JointTrajectory & traj);
+  bool call_gripper(osrf_gear::VacuumGripperControl & srv);
+  bool call_agv(int agv, osrf_gear::AGVControl & srv);
+  void publish_diagnostics(const diagnostic_msgs::DiagnosticArray & diagnostics);
+
+private:
+  Transport & transport_;
+  Instrumentation & instrumentation_;
+};
+
+#endif  // ARIAC_EXAMPLE_INSTRUMENTATION_H
@@ -0,0 +1,57 @@
+#ifndef ARIAC_EXAMPLE_JOINT_INDEX_H
+#define ARIAC_EXAMPLE_JOINT_INDEX_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <sensor_msgs/JointState.h>
+
+/// Number of controllable arm joints (the vacuum_gripper_joint is not one).
+static const size_t kNumArmJoints = 7;
+
+/// Joint positions in arm command order, see arm_joint_names().
+typedef std::array<double, kNumArmJoints> JointPositions;
+
+/// Names of the controllable joints, in the order used by JointPositions.
+const std::vector<std::string> & arm_joint_names();
+
+/*
+ * @brief Maps JointState messages onto the fixed arm joint layout.
+ *
+ * /ariac/joint_states does not promise any particular joint order, so the
+ * position of each arm joint in the message is looked up by name on the
+ * first message and cached. Later messages are only checked against the
+ * cached names; the lookup is redone only when they no longer match.
+ */
+class JointIndex
+{
+public:
+  JointIndex();
+
+  /*
+   * @brief Copy one field of a JointState into arm command order
+   * @param msg: joint state message, used to validate the cached mapping
+   * @param values: msg.position or msg.velocity
+   * @param out: filled with one value per arm joint
+   * @return false if the message is missing an arm joint or the field is short
+   */
+  bool gather(const sensor_msgs::JointState & msg, const std::vector<double> & values, JointPositions & out);
+
+  /// Shorthand for gather() on msg.position.
+  bool positions(const sensor_msgs::JointState & msg, JointPositions & out) {
+    return gather(msg, msg.position, out);
+  }
+
+  /// Whether a mapping has been resolved.
+  bool resolved() const { return resolved_; }
+
+private:
+  bool matches(const std::vector<std::string> & names) const;
+  bool resolve(const std::vector<std::string> & names);
+
+  std::array<size_t, kNumArmJoints> slot_;  ///< message index of each arm joint
+  size_t message_size_;
+  bool resolved_;
+};
+
+#endif  // ARIAC_EXAMPLE_JOINT_INDEX_H
@@ -0,0 +1,37 @@
+#ifndef ARIAC_EXAMPLE_LATEST_VALUE_H
+#define ARIAC_EXAMPLE_LATEST_VALUE_H
+
+#include <boost/shared_ptr.hpp>
+
+/*
+ * @brief Latest-value mailbox between a sensor callback and the control loop.
+ *
+ * The callback stores the message pointer it was handed and the control loop
+ * loads whatever is newest; nobody copies the message. Older values are
+ * simply overwritten.
+ *
+ * Not lock-free: boost's atomic shared_ptr operations take a spinlock from a
+ * small pool keyed by address. It is only held for a pointer swap or copy
+ * and a reference count update, so neither side waits on the other's work.
+ */
+template <class T>
+class LatestValue
+{
+public:
+  typedef boost::shared_ptr<const T> ConstPtr;
+
+  /// Publish a new value (called from the subscriber thread).
+  void store(const ConstPtr & value) {
+    boost::atomic_store(&value_, value);
+  }
+
+  /// Take a snapshot of the newest value, or a null pointer if none arrived yet.
+  ConstPtr load() const {
+    return boost::atomic_load(&value_);
+  }
+
+private:
+  ConstPtr value_;
+};
+
+#endif  // ARIAC_EXAMPLE_LATEST_VALUE_H
@@ -0,0 +1,67 @@
+#ifndef ARIAC_EXAMPLE_PART_INDEX_H
+#define ARIAC_EXAMPLE_PART_INDEX_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <geometry_msgs/Pose.h>
+#include <osrf_gear/LogicalCameraImage.h>
+
+/// A part seen by a logical camera, with its pose in the world frame.
+struct IndexedPart {
+  std::string type;
+  int camera;                 ///< logical camera that reported it
+  geometry_msgs::Pose pose;   ///< world frame
+  unsigned int frame;         ///< camera frame in which it was last seen
+};
+
+/*
+ * @brief Parts reported by the logical cameras, keyed by type.
+ *
+ * Every camera frame is merged into the index instead of rebuilding it: a
+ * model that is within the match distance of a known part of the same type
+ * updates that part, an unmatched model is added, and parts the camera no
+ * longer reports are dropped. Parts of one type are kept sorted along the
+ * rail axis (world y), so a nearest-part query is a binary search followed
+ * by a short walk outwards.
+ */
+class PartIndex
+{
+public:
+  explicit PartIndex(double match_distance = 0.05);
+
+  /*
+   * @brief Merge one logical camera frame into the index
+   * @param camera: id of the camera, e.g. 1 for /ariac/logical_camera_1
+   * @param image: the camera message; model poses are relative to image.pose
+   */
+  void update(int camera, const osrf_gear::LogicalCameraImage & image);
+
+  /*
+   * @brief Find the part of a type closest to a point
+   * @param type: part type, e.g. "gear_part"
+   * @param point: world position to measure from
+   * @param max_distance: parts further away than this are out of reach
+   * @param camera: only consider parts from this camera, or -1 for any
+   * @param part: filled with the closest part on success
+   * @return false if no part of that type is within reach
+   */
+  bool nearest(const std::string & type, const geometry_msgs::Point & point, double max_distance,
+               int camera, IndexedPart & part) const;
+
+  /// Number of indexed parts reported by one camera.
+  size_t count(int camera) const;
+
+  /// Whether a model type is a part (as opposed to a tray, AGV, bin...).
+  static bool is_part(const std::string & type);
+
+private:
+  typedef std::multimap<double, IndexedPart> Row;  ///< parts of one type, keyed by world y
+
+  std::map<std::string, Row> parts_;
+  std::map<int, unsigned int> frames_;  ///< last frame number of each camera
+  double match_distance_;
+  mutable std::mutex mutex_;
+};
+
+#endif  // ARIAC_EXAMPLE_PART_INDEX_H
@@ -0,0 +1,56 @@
+#ifndef ARIAC_EXAMPLE_PICK_PLANNER_H
+#define ARIAC_EXAMPLE_PICK_PLANNER_H
+
+#include <vector>
+
+#include "ariac_example/trajectory_timing.h"
+#include "ariac_example/waypoint_table.h"
+
+/*
+ * @brief Orders the pick/place cycles of a kit to minimise arm travel time.
+ *
+ * Every cycle goes start -> approach -> grasp -> approach -> place, with the
+ * times of each leg from TrajectoryTiming. Only the leg from one cycle's
+ * place goal to the next cycle's approach depends on the order, so this is
+ * an open asymmetric travelling salesman path from the start position.
+ *
+ * Up to exact_limit parts are solved exactly (Held-Karp); larger kits, or an
+ * exact search that runs out of the time budget, get nearest neighbour
+ * followed by relocate moves until nothing improves or the budget is spent.
+ */
+class PickPlanner
+{
+public:
+  PickPlanner();
+
+  void set_timing(const TrajectoryTiming & timing);
+
+  /// Wall time a plan() call may take, in seconds.
+  void set_time_budget(double seconds);
+
+  /// Largest number of parts solved exactly.
+  void set_exact_limit(size_t parts);
+
+  /*
+   * @brief Arm travel time of the cycles in a given order
+   * @param order: indices into picks/places
+   */
+  double cycle_time(const JointPositions & start, const std::vector<PickWaypoints> & picks,
+                    const std::vector<JointPositions> & places, const std::vector<size_t> & order) const;
+
+  /*
+   * @brief Find a fast order for the cycles
+   * @param picks, places: one entry per part, same length
+   * @param order: set to the visiting order, as indices into picks/places
+   * @return arm travel time of that order, in seconds
+   */
+  double plan(const JointPositions & start, const std::vector<PickWaypoints> & picks,
+              const std::vector<JointPositions> & places, std::vector<size_t> & order) const;
+
+private:
+  TrajectoryTiming timing_;
+  double time_budget_;
+  size_t exact_limit_;
+};
+
+#endif  // ARIAC_EXAMPLE_PICK_PLANNER_H
@@ -0,0 +1,55 @@
+#ifndef ARIAC_EXAMPLE_STARTUP_TRACKER_H
+#define ARIAC_EXAMPLE_STARTUP_TRACKER_H
+
+#include <array>
+#include <mutex>
+#include <ostream>
+#include <ros/ros.h>
+
+/*
+ * @brief When the node reached each step of its startup.
+ *
+ * The steps run in parallel: the control loop brings the arm to its ready
+ * pose and the TF cache fills while a startup thread warms the planner and
+ * IK table and waits for the competition. Each step is marked from the
+ * thread that gets there, and only the first mark counts. Times are
+ * reported relative to the competition start, so steps done before the
+ * clock started come out negative.
+ *
+ * Marks with a zero time (sim time before the first /clock) are ignored.
+ */
+class StartupTracker
+{
+public:
+  enum Milestone {
+    kSubscribed,     ///< every topic subscribed
+    kWarm,           ///< IK table filled and planner warmed up
+    kArmReady,       ///< arm at its ready pose
+    kTfReady,        ///< a fresh gripper transform in the TF cache
+    kServiceReady,   ///< /ariac/start_competition exists
+    kStarted,        ///< competition started
+    kFirstCommand,   ///< first arm command for a task
+    kNumMilestones
+  };
+
+  StartupTracker();
+
+  /// Record a milestone; true only for the first mark.
+  bool mark(Milestone milestone, const ros::Time & now);
+
+  bool reached(Milestone milestone) const;
+
+  /// Seconds from the competition start to a milestone; 0 if either is not reached.
+  double since_start(Milestone milestone) const;
+
+  /// Plain-text table of the milestones reached.
+  void write(std::ostream & out) const;
+
+  static const char * name(Milestone milestone);
+
+private:
+  std::array<ros::Time, kNumMilestones> stamps_;
+  mutable std::mutex mutex_;
+};
+
+#endif  // ARIAC_EXAMPLE_STARTUP_TRACKER_H
@@ -0,0 +1,95 @@
+#ifndef ARIAC_EXAMPLE_TASK_ENGINE_H
+#define ARIAC_EXAMPLE_TASK_ENGINE_H
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <osrf_gear/Order.h>
+
+#include "ariac_example/pick_planner.h"
+#include "ariac_example/waypoint_table.h"
+
+/// One part to move from a bin to a tray, with its waypoints resolved.
+struct PickPlaceTask {
+  std::string order_id;
+  std::string kit_type;
+  std::string part_type;
+  int bin = 0;
+  int bin_slot = 0;
+  int agv = 0;
+  int tray_slot = 0;
+  int kit = 0;         ///< sequence number of the kit across all orders
+  int kit_parts = 0;   ///< tasks queued for the kit
+  int order_kits = 0;  ///< kits queued for the order
+  PickWaypoints pick;
+  JointPositions place_goal;
+};
+
+/// Arm travel time of the kits of an order, as planned and in listed order.
+struct PlanStats {
+  double planned = 0.0;     ///< seconds
+  double sequential = 0.0;  ///< seconds
+};
+
+/*
+ * @brief Turns incoming orders into a queue of pick/place tasks.
+ *
+ * Each object of each kit becomes one task. The bin is chosen from the part
+ * type, and waypoints come from the WaypointTable, so new orders need no code
+ * changes as long as their part types are mapped to a bin. The parts of each
+ * kit are put in the order the PickPlanner finds fastest, starting from where
+ * the previous kit leaves the arm. Kits go to the AGVs in turn, so one tray
+ * can be filled while the other is away. Orders are queued back to back; add_order()
+ * is safe to call from the order callback while the control loop consumes
+ * tasks, plans without holding the queue, and queues each order whole.
+ */
+class TaskEngine
+{
+public:
+  explicit TaskEngine(const WaypointTable & table);
+
+  /// Map a part type to the bin it is picked from.
+  void set_part_bin(const std::string & part_type, int bin);
+
+  /// Bins that parts are picked from.
+  std::vector<int> bins() const;
+
+  /// AGVs whose trays kits are built on, in turn; AGV 1 only by default.
+  void set_agvs(const std::vector<int> & agvs);
+
+  /*
+   * @brief Expand an order into tasks and append them to the queue
+   * @return number of tasks queued; parts with no known bin are skipped
+   */
+  int add_order(const osrf_gear::Order & order, PlanStats * stats = NULL);
+
+  /// Where the arm is before the first task; the ready position by default.
+  void set_start(const JointPositions & start);
+
+  /// Set up before the first order arrives.
+  PickPlanner & planner() { return planner_; }
+
+  /// Copy the task at the front of the queue; false if the queue is empty.
+  bool front(PickPlaceTask & task) const;
+
+  /// Drop the task at the front of the queue once it has been placed.
+  void pop();
+
+  size_t pending() const;
+
+private:
+  const WaypointTable & table_;
+  std::map<std::string, int> part_bins_;
+  std::map<int, int> next_bin_slot_;
+  std::deque<PickPlaceTask> tasks_;
+  std::vector<int> agvs_;
+  size_t next_agv_;  ///< index into agvs_ of the AGV for the next kit
+  int next_kit_;
+  PickPlanner planner_;
+  JointPositions last_goal_;  ///< where the last queued task leaves the arm
+  mutable std::mutex mutex_;
+};
+
+#endif  // ARIAC_EXAMPLE_TASK_ENGINE_H
@@ -0,0 +1,221 @@
+#ifndef ARIAC_EXAMPLE_TASK_STATE_MACHINE_H
+#define ARIAC_EXAMPLE_TASK_STATE_MACHINE_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <ros/ros.h>
+
+/*
+ * @brief States of the arm, gripper and tray through a pick-and-place task, and their timing.
+ *
+ * The states form a tree: kTask holds kPick and kPlace, which hold the leaf
+ * states the machine is actually in. A table gives each state its parent
+ * and the events it wakes on. Every transition is timed, for each state
+ * left and for each from -> to pair, so write() shows where the cycle time
+ * goes. Transitions a handler takes because a state timed out are timed as
+ * edges of their own.
+ *
+ * Used from the control loop only; not thread safe.
+ */
+class TaskStates
+{
+public:
+  enum State {
+    kStartup,        ///< waiting for the first joint state to send the arm to ready
+    kIdle,           ///< no task, or its tray is away
+    kTask,           ///< a task is in progress
+    kPick,           ///< getting the part onto the gripper
+    kMoveToBin,      ///< on the way to the part in a bin
+    kGraspBin,       ///< gripper on over the bin, waiting for the part to attach
+    kWaitForPart,    ///< no part on the belt can be met yet
+    kHoverOverBelt,  ///< over the intercept point, waiting to go down
+    kMeetPart,       ///< going down to meet the part, gripper on
+    kPlace,          ///< getting the part onto the tray
+    kMoveToTray,     ///< carrying the part to its tray slot
+    kRelease,        ///< gripper off over the tray, waiting for it to confirm
+    kNumStates,
+    kNoState = kNumStates  ///< no parent; a handler returns it to stay put
+  };
+
+  /// Bits of the event mask passed to TaskStateMachine::dispatch().
+  enum Event {
+    kArmMoved = 1 << 0,          ///< a new joint state
+    kPartAttached = 1 << 1,
+    kPartDetached = 1 << 2,
+    kGripperConfirmed = 1 << 3,  ///< the gripper reached the state last requested
+    kTaskQueued = 1 << 4,
+    kTrayChanged = 1 << 5,       ///< a tray changed phase
+    kConveyorChanged = 1 << 6,   ///< a belt sensor fixed a part
+    kTimer = 1 << 7              ///< the time set with wake_at() has come
+  };
+
+  TaskStates();
+
+  static const char * name(State state);
+  /// name() of a state number, as an event log stores it; see EventLog::set_state_names().
+  static const char * name_of(int state);
+  static State parent(State state);
+  /// Events the state's own handler wakes on.
+  static uint32_t wakes_on(State state);
+  /// Whether `ancestor` is `state` or one of its parents.
+  static bool within(State state, State ancestor);
+
+  /// The state left by the last transition, seconds spent in it, and whether it timed out.
+  State last_from() const { return last_from_; }
+  double last_seconds() const { return last_seconds_; }
+  bool last_timed_out() const { return last_timed_out_; }
+
+  /// When the state was last entered.
+  const ros::Time & entered(State state) const { return entered_[state]; }
+
+  /// Plain-text table of time per state and per transition, over completed visits.
+  void write(std::ostream & out) const;
+
+protected:
+  /// Leave `from` (kNoState at start) for `to`: time every state left and enter every new one.
+  void record(State from, State to, const ros::Time & now, bool timed_out = false);
+
+private:
+  struct Stats {
+    size_t visits = 0;   ///< completed ones; the current visit is not counted yet
+    double total = 0.0;  ///< seconds
+    double max = 0.0;
+  };
+  struct Edge {
+    size_t count = 0;
+    double total = 0.0;  ///< seconds in the from state before taking this transition
+  };
+
+  std::array<Stats, kNumStates> stats_;
+  std::array<ros::Time, kNumStates> entered_;
+  std::array<std::array<Edge, kNumStates>, kNumStates> edges_;
+  std::array<std::array<Edge, kNumStates>, kNumStates> timeouts_;  ///< edges taken on a timeout
+  State last_from_;
+  double last_seconds_;
+  bool last_timed_out_;
+};
+
+/// Selects the owner's handler for a state by overload.
+template <TaskStates::State S>
+struct StateTag {};
+
+/*
+ * @brief Event-driven state machine over TaskStates, with handlers in the owner.
+ *
+ * The owner has one `TaskStates::State on(StateTag<S>)` overload per state
+ * that acts on events. A handler checks its guards, does the transition's
+ * actions and returns the next state, or kNoState to stay. The handlers are
+ * bound per state at compile time into a static table, so dispatch is an
+ * array lookup; states without a handler of their own need a catch-all
+ * template overload that returns kNoState.
+ *
+ * dispatch() runs the handlers of the current state and then its parents,
+ * skipping those that do not wake on any of the events, and stops at the
+ * first transition: at most one transition per call.
+ */
+template <class Owner>
+class TaskStateMachine : public TaskStates
+{
+public:
+  TaskStateMachine(Owner & owner, State initial)
+  : owner_(owner), state_(initial), armed_(false), timed_out_(false), started_(false) {}
+
+  State state() const { return state_; }
+
+  /// Start timing the initial state; later calls do nothing.
+  void start(const ros::Time & now) {
+    if (!started_) {
+      started_ = true;
+      record(kNoState, state_, now);
+    }
+  }
+
+  /*
+   * @brief Raise kTimer on the first tick at or after this time
+   *
+   * Replaces any earlier request. A request made by a handler that leaves
+   * the state carries over to the next one; otherwise it is dropped with the
+   * state that made it.
+   */
+  void wake_at(const ros::Time & time) {
+    deadline_ = time;
+    armed_ = true;
+  }
+
+  /// Mark the transition the running handler returns as taken because its state timed out.
+  void time_out() {
+    timed_out_ = true;
+  }
+
+  /// kTimer if the wake-up time has come, else 0.
+  uint32_t timer(const ros::Time & now) const {
+    return !deadline_.isZero() && now >= deadline_ ? kTimer : 0;
+  }
+
+  /// Whether the current state or one of its parents wakes on any of these events.
+  bool wants(uint32_t events) const {
+    for (State s = state_; s != kNoState; s = parent(s)) {
+      if (wakes_on(s) & events) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*
+   * @brief Hand a set of events to the handlers
+   * @param events: TaskStates::Event bits that happened since the last call
+   * @return whether the state changed
+   */
+  bool dispatch(uint32_t events, const ros::Time & now) {
+    start(now);
+    if (events & kTimer) {
+      deadline_ = ros::Time();  // One-shot; handlers ask again if they still need it.
+    }
+    for (State s = state_; s != kNoState; s = parent(s)) {
+      if (!(wakes_on(s) & events)) {
+        continue;
+      }
+      armed_ = false;
+      timed_out_ = false;
+      const State next = handler(s)(owner_);
+      if (next != kNoState) {
+        if (!armed_) {
+          deadline_ = ros::Time();
+        }
+        record(state_, next, now, timed_out_);
+        state_ = next;
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  typedef State (*Handler)(Owner &);
+
+  template <State S>
+  static State call(Owner & owner) {
+    return owner.on(StateTag<S>());
+  }
+
+  static Handler handler(State state) {
+    static_assert(kRelease + 1 == kNumStates, "one handler per state");
+    static const Handler handlers[kNumStates] = {
+      &call<kStartup>, &call<kIdle>, &call<kTask>, &call<kPick>, &call<kMoveToBin>, &call<kGraspBin>,
+      &call<kWaitForPart>, &call<kHoverOverBelt>, &call<kMeetPart>, &call<kPlace>, &call<kMoveToTray>,
+      &call<kRelease>
+    };
+    return handlers[state];
+  }
+
+  Owner & owner_;
+  State state_;
+  ros::Time deadline_;
+  bool armed_;      ///< wake_at() was called by the handler being run
+  bool timed_out_;  ///< time_out() was called by the handler being run
+  bool started_;
+};
+
+#endif  // ARIAC_EXAMPLE_TASK_STATE_MACHINE_H
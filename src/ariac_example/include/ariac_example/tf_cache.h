@@ -0,0 +1,88 @@
+#ifndef ARIAC_EXAMPLE_TF_CACHE_H
+#define ARIAC_EXAMPLE_TF_CACHE_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <ros/ros.h>
+#include <geometry_msgs/Point.h>
+#include <tf/transform_listener.h>
+
+/*
+ * @brief Long-lived transform cache shared by the grasp/place checks.
+ *
+ * The listener is created once and keeps filling its buffer from /tf in the
+ * background, so lookups never have to wait for a fresh listener to warm up.
+ * Frame pairs are registered (and their names resolved) once up front, and
+ * each lookup is non-blocking: it returns the newest available transform, or
+ * the last good one, as long as it is younger than the freshness limit.
+ * Lookups go through the buffer's public, locked API, and only when a
+ * transform has arrived since the pair was last looked up.
+ *
+ * Without a listener (e.g. when replaying a bag offline) the cache is fed
+ * transforms directly through add_transform().
+ */
+class TfCache
+{
+public:
+  /*
+   * @param listen: subscribe to /tf, or wait for add_transform() calls
+   * @param max_age: freshness limit, zero to accept transforms of any age
+   */
+  explicit TfCache(bool listen = true, const ros::Duration & max_age = ros::Duration(0.5));
+  ~TfCache();
+
+  /// Insert a transform, as read from a recorded /tf or /tf_static message.
+  void add_transform(const tf::StampedTransform & transform, bool is_static);
+
+  /*
+   * @brief Register a target/source frame pair to be looked up later
+   * @param target_frame: frame the transform is expressed in
+   * @param source_frame: frame being located
+   * @return handle to pass to lookup()
+   */
+  int add_frame_pair(const std::string & target_frame, const std::string & source_frame);
+
+  /*
+   * @brief Non-blocking lookup of the latest transform for a registered pair
+   * @param pair: handle returned by add_frame_pair()
+   * @param transform: filled with the cached transform on success
+   * @return false if no transform younger than the freshness limit is available
+   */
+  bool lookup(int pair, tf::StampedTransform & transform);
+
+  /*
+   * @brief Same as lookup(), but only returns the translation part
+   */
+  bool lookup_origin(int pair, geometry_msgs::Point & origin);
+
+  void set_max_age(const ros::Duration & max_age) { max_age_ = max_age; }
+  const ros::Duration & max_age() const { return max_age_; }
+
+private:
+  struct FramePair {
+    std::string target;
+    std::string source;
+    std::string target_id;  ///< without the leading slash, as tf2 names it
+    std::string source_id;
+    tf::StampedTransform last;
+    bool valid;
+    size_t changes;  ///< changes_ when the pair was last looked up
+  };
+
+  bool is_fresh(const tf::StampedTransform & transform) const;
+  /// Pick up a newer transform for a pair if there is one; true if its transform is usable. Called with mutex_ held.
+  bool refresh(int pair);
+
+  std::atomic<size_t> changes_{0};  ///< transforms inserted so far, counted from the listener thread
+  std::unique_ptr<tf::Transformer> transformer_;  ///< a TransformListener when listening
+  boost::signals2::connection changed_;
+  bool listening_;
+  ros::Duration max_age_;
+  std::vector<FramePair> pairs_;
+  std::mutex mutex_;
+};
+
+#endif  // ARIAC_EXAMPLE_TF_CACHE_H
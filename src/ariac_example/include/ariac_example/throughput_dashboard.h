@@ -0,0 +1,131 @@
+#ifndef ARIAC_EXAMPLE_THROUGHPUT_DASHBOARD_H
+#define ARIAC_EXAMPLE_THROUGHPUT_DASHBOARD_H
+
+#include <array>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <ros/ros.h>
+#include <diagnostic_msgs/DiagnosticArray.h>
+
+/*
+ * @brief Score, parts and time use over a competition run.
+ *
+ * Fed by the node as things happen: the competition start, parts started
+ * and placed, kits submitted, score updates, and every control tick what
+ * the cell is waiting on. Each score change is credited to the latest part
+ * placement or kit submission before it. Time is only counted from the
+ * competition start, as scoring does.
+ *
+ * A sample row is kept every sample period and at every score change, in a
+ * ring allocated up front; once it is full the oldest rows are dropped.
+ * write_series() saves them as CSV, one file per run, for comparing
+ * settings across replays.
+ *
+ * Safe to feed from the callback threads and the control loop at once.
+ */
+class ThroughputDashboard
+{
+public:
+  /// What the cell is waiting on.
+  enum Activity {
+    kStarting,   ///< before the first task can start
+    kNoOrder,    ///< nothing queued
+    kTrayAway,   ///< the next task's tray is not back yet
+    kMotion,     ///< the arm is moving, or settling into the grasp or place tolerance
+    kTf,         ///< the arm is there, but the gripper transform is missing or stale
+    kGripper,    ///< waiting for the part to attach or the gripper to turn off
+    kSensors,    ///< waiting for a part on the belt
+    kNumActivities
+  };
+
+  /// What a score change is credited to.
+  enum Cause {
+    kPart,
+    kKit,
+    kUnknown,    ///< no part or kit before it
+    kNumCauses
+  };
+
+  /*
+   * @param sample_period: seconds between sample rows
+   * @param max_samples: rows kept, counting score changes
+   */
+  explicit ThroughputDashboard(double sample_period = 1.0, size_t max_samples = 4096);
+
+  /// The competition clock starts; earlier time is not counted.
+  void start(const ros::Time & now);
+
+  /// What the cell is waiting on from now; called every control tick.
+  void activity(Activity activity, const ros::Time & now);
+
+  /// Work on a part began; repeated calls before part_placed() are ignored.
+  void part_started(const ros::Time & now);
+  void part_placed(const ros::Time & now);
+  void kit_submitted(const ros::Time & now);
+
+  /// Latest /ariac/current_score.
+  void score(double score, const ros::Time & now);
+
+  /// Points per minute of competition time so far.
+  double points_per_minute(const ros::Time & now) const;
+
+  /// Append a DiagnosticStatus with the live figures.
+  void fill(diagnostic_msgs::DiagnosticArray & diagnostics, const ros::Time & now) const;
+
+  /// Plain-text summary of the run.
+  void write(std::ostream & out) const;
+
+  /// Save the sample rows as CSV; false if the file cannot be written.
+  bool write_series(const std::string & path) const;
+
+  static const char * name(Activity activity);
+  static const char * name(Cause cause);
+
+private:
+  struct Sample {
+    double t;                 ///< seconds since the start
+    double score;
+    size_t parts;
+    size_t kits;
+    double cycle_mean;        ///< seconds per placed part
+    std::array<double, kNumActivities> seconds;
+    int cause;                ///< Cause of a score change, -1 for a periodic sample
+  };
+
+  struct Credit {
+    size_t count = 0;
+    double points = 0.0;
+    double latency = 0.0;     ///< seconds from the credited event to the score change, summed
+  };
+
+  /// Add the time since the last update to the current activity.
+  void advance(const ros::Time & now);
+  void push(const ros::Time & now, int cause);
+  double minutes(const ros::Time & now) const;
+
+  double sample_period_;
+  ros::Time start_;
+  ros::Time last_update_;
+  ros::Time next_sample_;
+  Activity activity_;
+  std::array<double, kNumActivities> seconds_;
+  double score_;
+  size_t parts_;
+  size_t kits_;
+  ros::Time part_start_;
+  size_t cycles_;           ///< placed parts with a known start
+  double cycle_total_;
+  double cycle_min_;
+  double cycle_max_;
+  ros::Time last_part_;
+  ros::Time last_kit_;
+  std::array<Credit, kNumCauses> credits_;
+  std::vector<Sample> samples_;  ///< ring of at most max_samples_ rows
+  size_t max_samples_;
+  size_t oldest_;               ///< index of the first row once the ring is full
+  mutable std::mutex mutex_;
+};
+
+#endif  // ARIAC_EXAMPLE_THROUGHPUT_DASHBOARD_H
@@ -0,0 +1,60 @@
+#ifndef ARIAC_EXAMPLE_TRAJECTORY_BUILDER_H
+#define ARIAC_EXAMPLE_TRAJECTORY_BUILDER_H
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include <trajectory_msgs/JointTrajectory.h>
+
+#include "ariac_example/joint_index.h"
+#include "ariac_example/trajectory_timing.h"
+
+/*
+ * @brief Builds multi-point arm trajectories with per-segment timing.
+ *
+ * All waypoints of a motion go out in one JointTrajectory, so the controller
+ * blends through them instead of stopping at each one and waiting for the
+ * next command. Segment durations come from TrajectoryTiming.
+ *
+ * The message is a template built once in the constructor: joint names are
+ * filled in there, and trajectory points (with their position buffers) are
+ * preallocated and recycled, so building a trajectory of up to kMaxPoints
+ * points does not touch the heap.
+ */
+class TrajectoryBuilder
+{
+public:
+  /// Trajectories up to this many points are built without allocating.
+  static const size_t kMaxPoints = 8;
+
+  TrajectoryBuilder();
+
+  /// Per-joint limits used to time each segment.
+  TrajectoryTiming & timing() { return timing_; }
+  const TrajectoryTiming & timing() const { return timing_; }
+
+  /*
+   * @brief Fill the trajectory template so it moves from start through every waypoint
+   * @param start: current joint positions, used to time the first segment
+   * @param waypoints: points to pass through; the last one is the goal
+   * @return the template, valid until the next call to build()
+   */
+  trajectory_msgs::JointTrajectory & build(const JointPositions & start,
+                                           std::initializer_list<const JointPositions *> waypoints);
+  trajectory_msgs::JointTrajectory & build(const JointPositions & start,
+                                           const std::vector<const JointPositions *> & waypoints);
+
+private:
+  /// Grow or shrink the template's points by moving them to and from the spare pool.
+  void set_point_count(size_t count);
+
+  template <class Iterator>
+  trajectory_msgs::JointTrajectory & fill(const JointPositions & start, Iterator begin, Iterator end,
+                                          size_t count);
+
+  TrajectoryTiming timing_;
+  trajectory_msgs::JointTrajectory traj_;
+  std::vector<trajectory_msgs::JointTrajectoryPoint> spare_points_;
+};
+
+#endif  // ARIAC_EXAMPLE_TRAJECTORY_BUILDER_H
@@ -0,0 +1,52 @@
+#ifndef ARIAC_EXAMPLE_TRAJECTORY_TIMING_H
+#define ARIAC_EXAMPLE_TRAJECTORY_TIMING_H
+
+#include <vector>
+
+#include "ariac_example/joint_index.h"
+
+/*
+ * @brief Time parameterization of joint-space segments.
+ *
+ * Every joint follows a rest-to-rest trapezoidal velocity profile bounded by
+ * its velocity and acceleration limits (triangular when the move is too
+ * short to reach full speed). A segment takes as long as its slowest joint,
+ * so short moves are quick and long moves stay inside the limits.
+ */
+class TrajectoryTiming
+{
+public:
+  /// Start with the UR10 and linear actuator limits, in command joint order.
+  TrajectoryTiming();
+
+  /*
+   * @brief Set the per-joint limits
+   * @param max_velocity: rad/s (m/s for the rail), one per joint
+   * @param max_acceleration: rad/s^2 (m/s^2 for the rail), one per joint
+   * @param scale: fraction of the limits actually used, in (0, 1]
+   * @return false, leaving the limits unchanged, if the input is invalid
+   */
+  bool set_limits(const std::vector<double> & max_velocity,
+                  const std::vector<double> & max_acceleration, double scale);
+
+  const std::vector<double> & max_velocity() const { return max_velocity_; }
+  const std::vector<double> & max_acceleration() const { return max_acceleration_; }
+
+  /// Lower bound on the duration of any one segment, in seconds.
+  void set_min_segment_time(double seconds) { min_segment_time_ = seconds; }
+
+  /// Time needed to move between two joint configurations, in seconds.
+  double segment_time(const JointPositions & from, const JointPositions & to) const;
+
+  /// Time for one joint to cover a distance from rest to rest.
+  static double rest_to_rest_time(double distance, double max_velocity, double max_acceleration);
+
+private:
+  std::vector<double> max_velocity_;
+  std::vector<double> max_acceleration_;
+  std::vector<double> scaled_velocity_;
+  std::vector<double> scaled_acceleration_;
+  double min_segment_time_;
+};
+
+#endif  // ARIAC_EXAMPLE_TRAJECTORY_TIMING_H
@@ -0,0 +1,53 @@
+#ifndef ARIAC_EXAMPLE_TRANSPORT_H
+#define ARIAC_EXAMPLE_TRANSPORT_H
+
+#include <ros/ros.h>
+#include <diagnostic_msgs/DiagnosticArray.h>
+#include <osrf_gear/AGVControl.h>
+#include <osrf_gear/VacuumGripperControl.h>
+#include <trajectory_msgs/JointTrajectory.h>
+
+/*
+ * @brief Everything MyCompetitionClass sends out of the node.
+ *
+ * Incoming data reaches the class through its callbacks, so this interface
+ * is all that ties it to a live ROS graph. The node uses RosTransport; the
+ * offline replay driver swaps in a stub that records the commands instead.
+ */
+class Transport
+{
+public:
+  virtual ~Transport() {}
+
+  /// Send a command to /ariac/arm/command.
+  virtual void publish_arm_command(const trajectory_msgs::JointTrajectory & traj) = 0;
+
+  /// Call /ariac/gripper/control; false if the call itself failed.
+  virtual bool call_gripper(osrf_gear::VacuumGripperControl & srv) = 0;
+
+  /// Call /ariac/agv<agv> to submit its tray; false if the call itself failed.
+  virtual bool call_agv(int agv, osrf_gear::AGVControl & srv) = 0;
+
+  /// Send the periodic timing report to /diagnostics.
+  virtual void publish_diagnostics(const diagnostic_msgs::DiagnosticArray & diagnostics) = 0;
+};
+
+/// Transport backed by a real publisher and service client.
+class RosTransport : public Transport
+{
+public:
+  explicit RosTransport(ros::NodeHandle & node);
+
+  void publish_arm_command(const trajectory_msgs::JointTrajectory & traj);
+  bool call_gripper(osrf_gear::VacuumGripperControl & srv);
+  bool call_agv(int agv, osrf_gear::AGVControl & srv);
+  void publish_diagnostics(const diagnostic_msgs::DiagnosticArray & diagnostics);
+
+private:
+  ros::Publisher joint_trajectory_publisher_;
+  ros::Publisher diagnostics_publisher_;
+  ros::ServiceClient gripper_service_;
+  ros::ServiceClient agv_services_[2];  ///< /ariac/agv1, /ariac/agv2
+};
+
+#endif  // ARIAC_EXAMPLE_TRANSPORT_H
@@ -0,0 +1,119 @@
+#ifndef ARIAC_EXAMPLE_TRAY_MANAGER_H
+#define ARIAC_EXAMPLE_TRAY_MANAGER_H
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ros/ros.h>
+
+#include "ariac_example/task_engine.h"
+#include "ariac_example/transport.h"
+
+/*
+ * @brief Kit state of each AGV tray, and submission of finished kits.
+ *
+ * A tray is idle, filling one kit, being submitted, or away with the AGV.
+ * A kit is finished when the tray camera sees all of its parts. On a tray
+ * with no camera, it is finished when every part has been placed. Finished
+ * kits are handed to the AGV from a worker thread, so the arm goes straight
+ * on to the other tray; the tray is back after the transit time.
+ *
+ * Without the worker (offline replay) the AGV is called inline from
+ * update(), which keeps the run deterministic.
+ */
+class TrayManager
+{
+public:
+  enum Phase {
+    kIdle,
+    kFilling,
+    kSubmitting,
+    kInTransit
+  };
+
+  /*
+   * @param transport: makes the /ariac/agvN calls
+   * @param use_worker: call from a worker thread, or inline from update()
+   * @param transit: time from submitting a tray to it being back, empty
+   */
+  TrayManager(Transport & transport, bool use_worker, const ros::Duration & transit);
+  ~TrayManager();
+
+  /// The AGV whose tray a camera watches; its count then decides when a kit is done.
+  void set_camera(int agv);
+
+  /// Whether the arm can place a part of this kit on the AGV's tray now.
+  bool available(int agv, int kit) const;
+
+  /// The first part of a kit is on its way to an idle tray.
+  void start_kit(const PickPlaceTask & task, const ros::Time & now);
+
+  /// A part was released on the tray.
+  void placed(int agv, const ros::Time & now);
+
+  /// A part of the kit was given up on; the kit is finished without it.
+  void skipped(int agv, const ros::Time & now);
+
+  /// Parts the tray camera sees on the AGV's tray.
+  void seen(int agv, int parts);
+
+  /// Submit finished kits and take back trays whose AGV has returned; call every control tick.
+  void update(const ros::Time & now);
+
+  Phase phase(int agv) const;
+
+  /// Phase changes over all trays so far; a new value means some tray moved on.
+  size_t changes() const;
+
+  /// Kits submitted, orders with every kit submitted, and orders completed per minute of work.
+  size_t kits_submitted() const;
+  size_t orders_completed() const;
+  double orders_per_minute() const;
+
+  /// Plain-text throughput summary.
+  void write(std::ostream & out) const;
+
+  static const char * name(Phase phase);
+
+private:
+  struct Tray {
+    Phase phase = kIdle;
+    int kit = -1;
+    std::string order_id;
+    std::string kit_type;
+    int order_kits = 0;
+    int expected = 0;        ///< parts in the kit
+    int placed = 0;
+    int seen = 0;            ///< parts the camera reports, if it watches this tray
+    bool watched = false;
+    bool call_pending = false;
+    bool call_done = false;
+    bool call_ok = false;
+    ros::Time since;         ///< when the current phase started
+  };
+
+  void run();
+  bool call(int agv, const std::string & kit_type);
+  /// Book a submitted kit against its order.
+  void submitted(Tray & tray, const ros::Time & now);
+
+  Transport & transport_;
+  double transit_;  ///< seconds a submitted tray is away
+  std::map<int, Tray> trays_;
+  std::map<std::string, int> order_kits_submitted_;
+  size_t changes_;
+  size_t kits_submitted_;
+  size_t orders_completed_;
+  ros::Time first_start_;
+  ros::Time last_completed_;
+  bool running_;
+  mutable std::mutex mutex_;
+  std::condition_variable changed_;
+  std::thread worker_;
+};
+
+#endif  // ARIAC_EXAMPLE_TRAY_MANAGER_H
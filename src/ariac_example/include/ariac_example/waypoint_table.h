@@ -0,0 +1,61 @@
+#ifndef ARIAC_EXAMPLE_WAYPOINT_TABLE_H
+#define ARIAC_EXAMPLE_WAYPOINT_TABLE_H
+
+#include <map>
+#include <vector>
+
+#include "ariac_example/joint_index.h"
+
+/// Waypoints used to pick one part out of a bin.
+struct PickWaypoints {
+  JointPositions approach;  ///< above the bin, clear of the bin walls
+  JointPositions grasp;     ///< gripper on the part
+};
+
+/*
+ * @brief Precomputed joint waypoints keyed by bin slot and tray slot.
+ *
+ * Bin slots are consumed in order as parts are taken from a bin; tray slots
+ * are indexed by the position of the part in its kit. A slot past the end of
+ * the table reuses the last entry, so a table with one tray goal works for
+ * any kit size. Bin kConveyor holds one pose over the middle of the belt;
+ * belt picks replace it with IK solutions over the tracked part.
+ */
+class WaypointTable
+{
+public:
+  /// Bin number for parts taken off the conveyor.
+  static const int kConveyor = 0;
+
+  /// Build the table with the hand-tuned qual1a waypoints.
+  WaypointTable();
+
+  void add_bin_slot(int bin, const JointPositions & approach, const JointPositions & grasp);
+  void add_tray_slot(int agv, const JointPositions & goal);
+
+  /*
+   * @brief Look up the pick waypoints for a bin slot
+   * @return false if the bin is not in the table
+   */
+  bool pick(int bin, int slot, PickWaypoints & waypoints) const;
+
+  /*
+   * @brief Look up the place goal for a tray slot
+   * @return false if the AGV is not in the table
+   */
+  bool place(int agv, int slot, JointPositions & goal) const;
+
+  /// Number of distinct slots of a bin or tray; 0 if it is not in the table.
+  size_t bin_slots(int bin) const;
+  size_t tray_slots(int agv) const;
+
+  /// Joint positions the arm is sent to before the first task.
+  const JointPositions & ready() const { return ready_; }
+
+private:
+  std::map<int, std::vector<PickWaypoints> > bins_;
+  std::map<int, std::vector<JointPositions> > trays_;
+  JointPositions ready_;
+};
+
+#endif  // ARIAC_EXAMPLE_WAYPOINT_TABLE_H
@@ -0,0 +1,215 @@
+#include "ariac_example/arm_kinematics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// UR10 DH parameters (ur_kinematics).
+const double kD[6] = {0.1273, 0.0, 0.0, 0.163941, 0.1157, 0.0922};
+const double kA[6] = {0.0, -0.612, -0.5723, 0.0, 0.0, 0.0};
+const double kAlpha[6] = {M_PI / 2, 0.0, 0.0, M_PI / 2, -M_PI / 2, 0.0};
+
+// Position of each DH joint in the JointPositions layout (see arm_joint_names()).
+const int kDhJoint[6] = {3, 2, 0, 4, 5, 6};
+const int kRail = 1;
+
+// Unknowns of the inverse: the rail and the first five DH joints.
+const int kUnknowns = 6;
+const int kResiduals = 5;  // gripper position, and the x/y tilt of its axis
+
+Vec3 cross(const Vec3 & a, const Vec3 & b) {
+  Vec3 c = {{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]}};
+  return c;
+}
+
+/// Solve the symmetric positive definite system a x = b in place (b becomes x).
+bool solve5(double a[kResiduals][kResiduals], double b[kResiduals]) {
+  for (int i = 0; i < kResiduals; ++i) {
+    double sum = a[i][i];
+    for (int k = 0; k < i; ++k) {
+      sum -= a[i][k] * a[i][k];
+    }
+    if (sum <= 0.0) {
+      return false;
+    }
+    a[i][i] = std::sqrt(sum);
+    for (int j = i + 1; j < kResiduals; ++j) {
+      double s = a[j][i];
+      for (int k = 0; k < i; ++k) {
+        s -= a[j][k] * a[i][k];
+      }
+      a[j][i] = s / a[i][i];
+    }
+  }
+  for (int i = 0; i < kResiduals; ++i) {
+    for (int k = 0; k < i; ++k) {
+      b[i] -= a[i][k] * b[k];
+    }
+    b[i] /= a[i][i];
+  }
+  for (int i = kResiduals - 1; i >= 0; --i) {
+    for (int k = i + 1; k < kResiduals; ++k) {
+      b[i] -= a[k][i] * b[k];
+    }
+    b[i] /= a[i][i];
+  }
+  return true;
+}
+
+}  // namespace
+
+ArmKinematics::ArmKinematics()
+: tool_length_(0.0), rail_lower_(-2.1), rail_upper_(2.1)
+{
+  // linear_arm_actuator_joint mount in the ARIAC 2017 qual1a world, at rail position 0. Checked
+  // against config/team_conf.yaml: it puts the hand-tuned AGV 1 waypoint under logical_camera_2
+  // (y = 3.15) and the belt waypoint at x = 1.21, between the conveyor sensors. ~arm_base overrides it.
+  Vec3 origin = {{0.3, 0.0, 0.9}};
+  set_base(origin, M_PI);
+}
+
+void ArmKinematics::set_base(const Vec3 & origin, double yaw) {
+  base_origin_ = origin;
+  base_cos_ = std::cos(yaw);
+  base_sin_ = std::sin(yaw);
+}
+
+void ArmKinematics::set_tool_length(double length) {
+  tool_length_ = length;
+}
+
+void ArmKinematics::set_rail_limits(double lower, double upper) {
+  rail_lower_ = lower;
+  rail_upper_ = upper;
+}
+
+void ArmKinematics::chain(const JointPositions & q, Frames & frames) const {
+  // Rotation columns (x, y, z axes) and origin of the current frame, in the world.
+  Vec3 x = {{base_cos_, base_sin_, 0.0}};
+  Vec3 y = {{-base_sin_, base_cos_, 0.0}};
+  Vec3 z = {{0.0, 0.0, 1.0}};
+  Vec3 p = base_origin_;
+  p[1] += q[kRail];
+  for (int i = 0; i < 6; ++i) {
+    frames.origin[i] = p;
+    frames.axis[i] = z;
+    const double ct = std::cos(q[kDhJoint[i]]);
+    const double st = std::sin(q[kDhJoint[i]]);
+    const double ca = std::cos(kAlpha[i]);
+    const double sa = std::sin(kAlpha[i]);
+    // Rz(theta) Tz(d) Tx(a) Rx(alpha), applied to the current frame.
+    Vec3 xr, yr, zr;
+    for (int k = 0; k < 3; ++k) {
+      xr[k] = ct * x[k] + st * y[k];
+      yr[k] = -st * x[k] + ct * y[k];
+    }
+    for (int k = 0; k < 3; ++k) {
+      p[k] += kD[i] * z[k] + kA[i] * xr[k];
+      zr[k] = -sa * yr[k] + ca * z[k];
+      yr[k] = ca * yr[k] + sa * z[k];
+    }
+    x = xr;
+    y = yr;
+    z = zr;
+  }
+  for (int k = 0; k < 3; ++k) {
+    frames.tool[k] = p[k] + tool_length_ * z[k];
+  }
+  frames.tool_axis = z;
+}
+
+void ArmKinematics::forward(const JointPositions & q, ToolPose & pose) const {
+  Frames frames;
+  chain(q, frames);
+  pose.position = frames.tool;
+  pose.axis = frames.tool_axis;
+}
+
+void ArmKinematics::link_points(const JointPositions & q, LinkPoints & points) const {
+  Frames frames;
+  chain(q, frames);
+  for (int i = 0; i < 6; ++i) {
+    points[i] = frames.origin[i];
+  }
+  points[6] = frames.tool;
+}
+
+bool ArmKinematics::refine(const Vec3 & target, JointPositions & q, int max_iterations,
+                           double tolerance, double * error) const {
+  const double damping = 1e-4;  // squared; keeps steps bounded near singularities
+  Frames frames;
+  double position_error = 0.0;
+  bool converged = false;
+  for (int iteration = 0; ; ++iteration) {
+    chain(q, frames);
+    double residual[kResiduals];
+    for (int k = 0; k < 3; ++k) {
+      residual[k] = target[k] - frames.tool[k];
+    }
+    // Pointing down: the axis has no x or y component (and points down, checked below).
+    residual[3] = -frames.tool_axis[0];
+    residual[4] = -frames.tool_axis[1];
+    position_error = std::sqrt(residual[0] * residual[0] + residual[1] * residual[1] +
+                               residual[2] * residual[2]);
+    const double tilt = std::sqrt(residual[3] * residual[3] + residual[4] * residual[4]);
+    converged = position_error < tolerance && tilt < tolerance && frames.tool_axis[2] < 0.0;
+    if (converged || iteration >= max_iterations) {
+      break;
+    }
+
+    // Jacobian columns: the rail, then the DH joints pan, lift, elbow, wrist_1, wrist_2.
+    double jacobian[kResiduals][kUnknowns];
+    jacobian[0][0] = 0.0;
+    jacobian[1][0] = 1.0;
+    jacobian[2][0] = 0.0;
+    jacobian[3][0] = 0.0;
+    jacobian[4][0] = 0.0;
+    for (int j = 0; j < 5; ++j) {
+      const Vec3 & axis = frames.axis[j];
+      Vec3 lever;
+      for (int k = 0; k < 3; ++k) {
+        lever[k] = frames.tool[k] - frames.origin[j][k];
+      }
+      const Vec3 dp = cross(axis, lever);
+      const Vec3 da = cross(axis, frames.tool_axis);
+      jacobian[0][j + 1] = dp[0];
+      jacobian[1][j + 1] = dp[1];
+      jacobian[2][j + 1] = dp[2];
+      jacobian[3][j + 1] = da[0];
+      jacobian[4][j + 1] = da[1];
+    }
+
+    // step = J^T (J J^T + damping I)^-1 residual
+    double jjt[kResiduals][kResiduals];
+    for (int r = 0; r < kResiduals; ++r) {
+      for (int c = 0; c <= r; ++c) {
+        double sum = 0.0;
+        for (int k = 0; k < kUnknowns; ++k) {
+          sum += jacobian[r][k] * jacobian[c][k];
+        }
+        jjt[r][c] = sum;
+        jjt[c][r] = sum;
+      }
+      jjt[r][r] += damping;
+    }
+    if (!solve5(jjt, residual)) {
+      break;
+    }
+    double step[kUnknowns];
+    for (int k = 0; k < kUnknowns; ++k) {
+      step[k] = 0.0;
+      for (int r = 0; r < kResiduals; ++r) {
+        step[k] += jacobian[r][k] * residual[r];
+      }
+    }
+    q[kRail] = std::min(rail_upper_, std::max(rail_lower_, q[kRail] + step[0]));
+    for (int j = 0; j < 5; ++j) {
+      q[kDhJoint[j]] += step[j + 1];
+    }
+  }
+  if (error) {
+    *error = position_error;
+  }
+  return converged;
+}
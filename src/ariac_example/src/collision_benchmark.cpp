@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include "ariac_example/collision_model.h"
+#include "ariac_example/waypoint_table.h"
+
+/*
+ * Benchmark for the collision model: configuration checks and segment
+ * checks per second, on random configurations around the hand-tuned
+ * waypoints, plus whether the hand-tuned motions themselves are clear.
+ *
+ * Usage: ariac_example_collision_benchmark [samples]
+ */
+int main(int argc, char ** argv) {
+  const int samples = argc > 1 ? std::atoi(argv[1]) : 100000;
+  if (samples <= 0) {
+    std::cerr << "Usage: " << argv[0] << " [samples]" << std::endl;
+    return 1;
+  }
+
+  WaypointTable waypoints;
+  ArmKinematics kinematics;
+  CollisionModel model(kinematics);
+  model.add_ariac_cell();
+  model.set_tuck(waypoints.ready());
+  std::cout << "model: " << model.spheres() << " spheres, " << model.boxes() << " boxes" << std::endl;
+
+  // The motions the node makes with the hand-tuned table.
+  std::vector<JointPositions> seeds;
+  seeds.push_back(waypoints.ready());
+  for (int bin = 6; bin <= 7; ++bin) {
+    PickWaypoints pick;
+    for (int slot = 0; waypoints.pick(bin, slot, pick) && slot < 2; ++slot) {
+      std::cout << "bin " << bin << " slot " << slot << ": approach "
+                << (model.free(pick.approach) ? "free" : "blocked") << ", grasp "
+                << (model.free(pick.grasp) ? "free" : "blocked") << ", approach->grasp "
+                << (model.segment_free(pick.approach, pick.grasp) ? "free" : "blocked") << std::endl;
+      seeds.push_back(pick.approach);
+      seeds.push_back(pick.grasp);
+    }
+  }
+  JointPositions place;
+  if (waypoints.place(1, 0, place)) {
+    seeds.push_back(place);
+  }
+
+  std::mt19937 random(3);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  std::vector<JointPositions> configs(samples);
+  for (int i = 0; i < samples; ++i) {
+    configs[i] = seeds[i % seeds.size()];
+    for (size_t j = 0; j < kNumArmJoints; ++j) {
+      configs[i][j] += 0.3 * unit(random);
+    }
+  }
+
+  int clear = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < samples; ++i) {
+    clear += model.free(configs[i]);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "configurations: " << samples / elapsed.count() << " checks/s ("
+            << clear << "/" << samples << " free)" << std::endl;
+
+  const int segments = samples / 10;
+  int routed = 0, via = 0;
+  JointPositions points[2];
+  TrajectoryTiming timing;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i + 1 < segments; ++i) {
+    const int count = model.route(configs[i], configs[i + 1], timing, points);
+    routed += count >= 0;
+    via += count > 0 ? count : 0;
+  }
+  elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "segments routed: " << (segments - 1) / elapsed.count() << " routes/s ("
+            << routed << "/" << segments - 1 << " routed, " << via << " waypoints added)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,191 @@
+#include "ariac_example/collision_model.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Links as pairs of ArmKinematics::link_points() indices, with the radius of their spheres.
+struct Link {
+  int from;
+  int to;
+  double radius;
+};
+
+const Link kLinks[] = {
+  {0, 1, 0.09},   // shoulder
+  {1, 2, 0.085},  // upper arm
+  {2, 3, 0.07},   // forearm
+  {3, 4, 0.06},   // wrist 1
+  {4, 5, 0.06},   // wrist 2
+  {5, 6, 0.05},   // wrist 3 and the vacuum gripper
+};
+const size_t kNumLinks = sizeof(kLinks) / sizeof(kLinks[0]);
+
+double distance(const Vec3 & a, const Vec3 & b) {
+  return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) +
+                   (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+}  // namespace
+
+CollisionModel::CollisionModel(const ArmKinematics & kinematics)
+: kinematics_(kinematics), max_step_(0.05)
+{
+  tuck_.fill(0.0);
+  // Link lengths do not depend on the configuration; space the spheres so they overlap.
+  JointPositions zero;
+  zero.fill(0.0);
+  ArmKinematics::LinkPoints points;
+  kinematics_.link_points(zero, points);
+  for (size_t l = 0; l < kNumLinks; ++l) {
+    const double length = distance(points[kLinks[l].from], points[kLinks[l].to]);
+    const size_t count = static_cast<size_t>(std::ceil(length / kLinks[l].radius)) + 1;
+    for (size_t i = 0; i < count; ++i) {
+      link_.push_back(static_cast<int>(l));
+      along_.push_back(count > 1 ? double(i) / (count - 1) : 0.0);
+      radius_.push_back(kLinks[l].radius);
+      radius_sq_.push_back(kLinks[l].radius * kLinks[l].radius);
+    }
+  }
+  x_.resize(radius_.size());
+  y_.resize(radius_.size());
+  z_.resize(radius_.size());
+}
+
+void CollisionModel::add_box(const std::string & name, const Vec3 & min, const Vec3 & max) {
+  box_names_.push_back(name);
+  box_min_x_.push_back(min[0]);
+  box_min_y_.push_back(min[1]);
+  box_min_z_.push_back(min[2]);
+  box_max_x_.push_back(max[0]);
+  box_max_y_.push_back(max[1]);
+  box_max_z_.push_back(max[2]);
+}
+
+void CollisionModel::add_ariac_cell() {
+  // ARIAC 2017 world: 0.6 m bins with origins at (-0.3, -0.535) and (-0.3, 0.23), parts on their floors at
+  // about 0.6 m; kit trays 0.8 x 0.6 m under logical_camera_2 at (0.3, +-3.15), their surface at about 0.75 m;
+  // the belt between the proximity sensor and break beam (team_conf.yaml), its surface at 0.91 m.
+  // Box tops are kept 0.08 m under those surfaces, so grasps and placements on them are free.
+  const double kBoxes[][6] = {
+    {-0.6, -0.835, 0.0, 0.0, -0.235, 0.52},
+    {-0.6, -0.07, 0.0, 0.0, 0.53, 0.52},
+    {-0.1, 2.85, 0.0, 0.7, 3.45, 0.67},
+    {-0.1, -3.45, 0.0, 0.7, -2.85, 0.67},
+    {0.9, -4.0, 0.0, 1.55, 4.5, 0.83},
+  };
+  const char * const kNames[] = {"bin6", "bin7", "agv1", "agv2", "conveyor"};
+  for (size_t i = 0; i < sizeof(kBoxes) / sizeof(kBoxes[0]); ++i) {
+    const Vec3 min = {{kBoxes[i][0], kBoxes[i][1], kBoxes[i][2]}};
+    const Vec3 max = {{kBoxes[i][3], kBoxes[i][4], kBoxes[i][5]}};
+    add_box(kNames[i], min, max);
+  }
+}
+
+void CollisionModel::place_spheres(const JointPositions & q) const {
+  ArmKinematics::LinkPoints points;
+  kinematics_.link_points(q, points);
+  for (size_t s = 0; s < radius_.size(); ++s) {
+    const Link & link = kLinks[link_[s]];
+    const Vec3 & a = points[link.from];
+    const Vec3 & b = points[link.to];
+    const double t = along_[s];
+    x_[s] = a[0] + t * (b[0] - a[0]);
+    y_[s] = a[1] + t * (b[1] - a[1]);
+    z_[s] = a[2] + t * (b[2] - a[2]);
+  }
+}
+
+bool CollisionModel::free(const JointPositions & q) const {
+  place_spheres(q);
+  const size_t n = radius_.size();
+  const double * x = x_.data();
+  const double * y = y_.data();
+  const double * z = z_.data();
+  const double * r2 = radius_sq_.data();
+  for (size_t b = 0; b < box_min_x_.size(); ++b) {
+    const double min_x = box_min_x_[b], max_x = box_max_x_[b];
+    const double min_y = box_min_y_[b], max_y = box_max_y_[b];
+    const double min_z = box_min_z_[b], max_z = box_max_z_[b];
+    // Branch free over the spheres so it vectorises: distance from each centre to the box.
+    int hit = 0;
+    for (size_t s = 0; s < n; ++s) {
+      const double dx = std::max(0.0, std::max(min_x - x[s], x[s] - max_x));
+      const double dy = std::max(0.0, std::max(min_y - y[s], y[s] - max_y));
+      const double dz = std::max(0.0, std::max(min_z - z[s], z[s] - max_z));
+      hit |= (dx * dx + dy * dy + dz * dz < r2[s]);
+    }
+    if (hit) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CollisionModel::segment_free(const JointPositions & a, const JointPositions & b) const {
+  double largest = 0.0;
+  for (size_t j = 0; j < kNumArmJoints; ++j) {
+    largest = std::max(largest, std::abs(b[j] - a[j]));
+  }
+  const int steps = std::max(1, static_cast<int>(std::ceil(largest / max_step_)));
+  JointPositions q;
+  for (int i = 0; i <= steps; ++i) {
+    const double t = double(i) / steps;
+    for (size_t j = 0; j < kNumArmJoints; ++j) {
+      q[j] = a[j] + t * (b[j] - a[j]);
+    }
+    if (!free(q)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int CollisionModel::route(const JointPositions & from, const JointPositions & to,
+                          const TrajectoryTiming & timing, JointPositions via[2]) const {
+  if (segment_free(from, to)) {
+    return 0;
+  }
+  // Tucked versions of both ends: same rail and base/wrist rotation, arm folded up.
+  JointPositions tucked_from = from, tucked_to = to;
+  const size_t kFolded[] = {0, 2, 4};  // elbow, shoulder_lift, wrist_1
+  for (size_t i = 0; i < 3; ++i) {
+    tucked_from[kFolded[i]] = tuck_[kFolded[i]];
+    tucked_to[kFolded[i]] = tuck_[kFolded[i]];
+  }
+
+  // Candidates, tried in order; the fastest free one wins.
+  int best = -1;
+  double best_time = 0.0;
+  const JointPositions * candidates[3][2] = {
+    {&tucked_from, NULL}, {&tucked_to, NULL}, {&tucked_from, &tucked_to}};
+  for (int c = 0; c < 3; ++c) {
+    const JointPositions * previous = &from;
+    double time = 0.0;
+    bool clear = true;
+    for (int k = 0; k < 2 && clear; ++k) {
+      const JointPositions * next = candidates[c][k];
+      if (!next) {
+        break;
+      }
+      clear = segment_free(*previous, *next);
+      time += timing.segment_time(*previous, *next);
+      previous = next;
+    }
+    clear = clear && segment_free(*previous, to);
+    time += timing.segment_time(*previous, to);
+    if (clear && (best < 0 || time < best_time)) {
+      best = c;
+      best_time = time;
+    }
+  }
+  if (best < 0) {
+    return -1;
+  }
+  int count = 0;
+  for (int k = 0; k < 2 && candidates[best][k]; ++k) {
+    via[count++] = *candidates[best][k];
+  }
+  return count;
+}
@@ -0,0 +1,757 @@
+#include "ariac_example/competition.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+MyCompetitionClass::MyCompetitionClass(Transport & transport, const CompetitionConfig & config)
+: current_score_(0), transport_(transport, instrumentation_),
+  diagnostics_period_(config.diagnostics_period), state_machine_(*this, TaskStates::kStartup),
+  gripper_(transport_, config.gripper_worker, ros::Duration(config.gripper_timeout)),
+  tf_cache_(config.listen_tf, ros::Duration(config.tf_max_age)),
+  events_(1024, config.event_console),
+  part_reach_(config.part_reach), agvs_(config.agvs),
+  warm_up_parts_(std::max(config.plan_exact_limit, 1)), task_engine_(waypoint_table_),
+  ik_table_(arm_kinematics(config), config.ik_resolution), ik_picks_(config.ik_picks),
+  pick_approach_height_(config.pick_approach_height), pick_grasp_height_(config.pick_grasp_height),
+  bin_move_timeout_(config.bin_move_timeout), bin_grasp_timeout_(config.bin_grasp_timeout),
+  pick_retries_(config.pick_retries),
+  collision_model_(arm_kinematics(config)), check_collisions_(config.check_collisions),
+  conveyor_untyped_(config.conveyor_untyped), conveyor_lead_time_(config.conveyor_lead_time),
+  trays_(transport_, config.gripper_worker, ros::Duration(config.agv_transit_time)),
+  tray_camera_agv_(config.tray_camera_agv), dashboard_(config.dashboard_period, std::max(config.dashboard_samples, 1)),
+  dashboard_file_(config.dashboard_file)
+{
+  if (!config.event_log_file.empty()) {
+    events_.open(config.event_log_file);
+  }
+  events_.set_state_names(&TaskStates::name_of);
+
+  // Which bin each part type is picked from.
+  for (std::map<std::string, int>::const_iterator it = config.part_bins.begin();
+       it != config.part_bins.end(); ++it) {
+    task_engine_.set_part_bin(it->first, it->second);
+  }
+
+  // Kits alternate between the AGVs; the tray camera's count decides when its tray is done.
+  task_engine_.set_agvs(config.agvs);
+  if (tray_camera_agv_ > 0) {
+    trays_.set_camera(tray_camera_agv_);
+  }
+
+  // Parts mapped to bin 0 come off the conveyor; the rest of the setup is for real bins.
+  bins_ = task_engine_.bins();
+  conveyor_picks_ = std::find(bins_.begin(), bins_.end(), WaypointTable::kConveyor) != bins_.end();
+  bins_.erase(std::remove(bins_.begin(), bins_.end(), WaypointTable::kConveyor), bins_.end());
+
+  // TF lookups are served from one long-lived listener; frames are resolved once here.
+  for (size_t i = 0; i < bins_.size(); ++i) {
+    std::ostringstream frame;
+    frame << "/bin" << bins_[i] << "_frame";
+    bin_frames_[bins_[i]] = tf_cache_.add_frame_pair(frame.str(), "/vacuum_gripper_link");
+  }
+  tray_frames_[1] = tf_cache_.add_frame_pair("/agv1_load_point_frame", "/vacuum_gripper_link");
+  tray_frames_[2] = tf_cache_.add_frame_pair("/agv2_load_point_frame", "/vacuum_gripper_link");
+  world_frames_ = tf_cache_.add_frame_pair("/world", "/vacuum_gripper_link");
+  bin_tolerance_.x = 0.25;
+  bin_tolerance_.y = 0.25;
+  bin_tolerance_.z = 0.1;
+  tray_tolerance_.x = 0.4;
+  tray_tolerance_.y = 0.4;
+  tray_tolerance_.z = 1;
+
+  // Segment timing follows the joint velocity/acceleration limits, scaled down for safety.
+  TrajectoryTiming & timing = trajectory_builder_.timing();
+  timing.set_limits(
+    config.max_joint_velocity.empty() ? timing.max_velocity() : config.max_joint_velocity,
+    config.max_joint_acceleration.empty() ? timing.max_acceleration() : config.max_joint_acceleration,
+    config.limit_scale);
+  timing.set_min_segment_time(config.min_segment_time);
+
+  // Kits are ordered for the least arm travel under the same timing.
+  PickPlanner & planner = task_engine_.planner();
+  planner.set_timing(timing);
+  planner.set_time_budget(config.plan_time_budget);
+  planner.set_exact_limit(config.plan_exact_limit);
+
+  // When a goal counts as reached.
+  if (!config.goal_tolerance.empty()) {
+    convergence_.set_position_tolerance(config.goal_tolerance);
+  }
+  convergence_.set_settle_velocity(config.settle_velocity);
+
+  // Belt picks are planned within the stretch of belt the arm reaches; the IK table is filled by warm_up().
+  if (config.conveyor_pick_window.size() == 2) {
+    conveyor_.set_pick_window(config.conveyor_pick_window[0], config.conveyor_pick_window[1]);
+  } else if (!config.conveyor_pick_window.empty()) {
+    ROS_ERROR("conveyor_pick_window must be [min_y, max_y]; using the default window");
+  }
+
+  // Every arm command is checked against the bins, trays and conveyor before it is sent.
+  if (config.obstacles.empty()) {
+    collision_model_.add_ariac_cell();
+  }
+  for (std::map<std::string, std::vector<double> >::const_iterator it = config.obstacles.begin();
+       it != config.obstacles.end(); ++it) {
+    const std::vector<double> & bounds = it->second;
+    if (bounds.size() != 6) {
+      ROS_ERROR("obstacle %s must be [min_x, min_y, min_z, max_x, max_y, max_z]; skipping it", it->first.c_str());
+      continue;
+    }
+    const Vec3 min = {{bounds[0], bounds[1], bounds[2]}};
+    const Vec3 max = {{bounds[3], bounds[4], bounds[5]}};
+    collision_model_.add_box(it->first, min, max);
+  }
+  collision_model_.set_tuck(waypoint_table_.ready());
+  route_.reserve(2 * kMaxRouteWaypoints);
+}
+
+ArmKinematics MyCompetitionClass::arm_kinematics(const CompetitionConfig & config) {
+  ArmKinematics kinematics;
+  if (config.arm_base.size() == 4) {
+    const Vec3 origin = {{config.arm_base[0], config.arm_base[1], config.arm_base[2]}};
+    kinematics.set_base(origin, config.arm_base[3]);
+  } else if (!config.arm_base.empty()) {
+    ROS_ERROR("arm_base must be [x, y, z, yaw]; using the default placement");
+  }
+  return kinematics;
+}
+
+void MyCompetitionClass::warm_up() {
+  {
+    ScopedTimer timer(instrumentation_, Instrumentation::kWarmUp);
+    // IK over the bin and tray workspaces, seeded from the hand-tuned waypoints.
+    const Vec3 half_extent = {{0.3, 0.3, 0.15}};
+    ik_table_.add_regions(waypoint_table_, bins_, agvs_, half_extent);
+
+    // Belt picks need IK over the whole stretch of belt the arm picks from.
+    PickWaypoints conveyor;
+    if (conveyor_picks_ && waypoint_table_.pick(WaypointTable::kConveyor, 0, conveyor)) {
+      const Vec3 min = {{1.06, conveyor_.pick_min_y(), 0.91}};
+      const Vec3 max = {{1.36, conveyor_.pick_max_y(), 0.91 + pick_approach_height_ + 0.1}};
+      ik_table_.add_region("conveyor", min, max, conveyor.approach);
+    }
+
+    // A throwaway kit drawn from the bin and tray waypoints.
+    std::vector<PickWaypoints> picks;
+    std::vector<JointPositions> places;
+    for (size_t i = 0; i < warm_up_parts_ && !bins_.empty() && !agvs_.empty(); ++i) {
+      PickWaypoints pick;
+      JointPositions place;
+      const int agv = agvs_[i % agvs_.size()];
+      if (waypoint_table_.pick(bins_[i % bins_.size()], 0, pick) &&
+          waypoint_table_.place(agv, i % std::max<size_t>(waypoint_table_.tray_slots(agv), 1), place)) {
+        picks.push_back(pick);
+        places.push_back(place);
+      }
+    }
+    std::vector<size_t> order;
+    if (!picks.empty()) {
+      task_engine_.planner().plan(waypoint_table_.ready(), picks, places, order);
+    }
+  }
+  warm_.store(true);
+  milestone(StartupTracker::kWarm);
+}
+
+void MyCompetitionClass::milestone(StartupTracker::Milestone milestone) {
+  const ros::Time now = ros::Time::now();
+  if (startup_.mark(milestone, now)) {
+    events_.log(EventLog::kStartup, StartupTracker::name(milestone));
+    if (milestone == StartupTracker::kStarted) {
+      dashboard_.start(now);
+    }
+  }
+}
+
+void MyCompetitionClass::add_transform(const tf::StampedTransform & transform, bool is_static) {
+  tf_cache_.add_transform(transform, is_static);
+}
+
+void MyCompetitionClass::current_score_callback(const std_msgs::Float32::ConstPtr & msg) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kCurrentScoreCallback);
+  if (msg->data != current_score_)
+  {
+    events_.log(EventLog::kScore, NULL, 0, 0, 0, msg->data);
+    dashboard_.score(msg->data, ros::Time::now());
+  }
+  current_score_ = msg->data;
+}
+
+void MyCompetitionClass::competition_state_callback(const std_msgs::String::ConstPtr & msg) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kCompetitionStateCallback);
+  if (msg->data != competition_state_)
+  {
+    events_.log(EventLog::kCompetitionState, msg->data.c_str());
+  }
+  if (msg->data == "go") {
+    milestone(StartupTracker::kStarted);
+  }
+  if (msg->data == "done") {
+    competition_done_.store(true);  // The control loop saves the time series.
+  }
+  competition_state_ = msg->data;
+}
+
+void MyCompetitionClass::order_callback(const osrf_gear::Order::ConstPtr & order_msg) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kOrderCallback);
+  PlanStats plan;
+  int queued = task_engine_.add_order(*order_msg, &plan);
+  events_.log(EventLog::kOrder, order_msg->order_id.c_str(), order_msg->kits.size(), queued, 0,
+    plan.planned, plan.sequential);
+}
+
+void MyCompetitionClass::joint_state_callback(const sensor_msgs::JointState::ConstPtr & joint_state_msg) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kJointStateCallback);
+  instrumentation_.record_age(Instrumentation::kJointStateAge, joint_state_msg->header.stamp);
+  events_.log(EventLog::kJointState, NULL, joint_state_msg->name.size());
+  // Only hand the message over; the control loop does the work.
+  current_joint_states_.store(joint_state_msg);
+}
+
+void MyCompetitionClass::control_tick() {
+  publish_diagnostics();
+  ScopedTimer timer(instrumentation_, Instrumentation::kControlTick);
+  const ros::Time now = ros::Time::now();
+  state_machine_.start(now);
+  trays_.update(now);
+  gripper_.update(now);
+  const uint32_t events = collect_events(now);
+  if (!ready_to_start()) {
+    check_ready();
+  }
+  dashboard_.activity(activity(), now);
+  if (competition_done_.load() && !series_written_) {
+    write_series();
+  }
+  if (!state_machine_.wants(events)) {
+    return;  // Nothing the current state waits on has happened.
+  }
+  if (state_machine_.dispatch(events, now)) {
+    events_.log(EventLog::kStateChange, TaskStates::name(state_machine_.state()),
+      state_machine_.last_from(), state_machine_.state(), state_machine_.last_timed_out(),
+      state_machine_.last_seconds());
+  }
+}
+
+bool MyCompetitionClass::write_series() {
+  if (dashboard_file_.empty() || series_written_) {
+    return true;
+  }
+  series_written_ = true;
+  if (!dashboard_.write_series(dashboard_file_)) {
+    ROS_ERROR_STREAM("Could not write the throughput time series to " << dashboard_file_);
+    return false;
+  }
+  return true;
+}
+
+uint32_t MyCompetitionClass::collect_events(const ros::Time & now) {
+  uint32_t events = state_machine_.timer(now);
+  sensor_msgs::JointState::ConstPtr joint_state_msg = current_joint_states_.load();
+  if (joint_state_msg && joint_state_msg != last_joint_state_) {
+    last_joint_state_ = joint_state_msg;
+    // Map the message onto the fixed arm joint layout; the name lookup is cached.
+    if (joint_index_.positions(*joint_state_msg, current_positions_)) {
+      has_velocities_ = convergence_.uses_velocity() &&
+        joint_index_.gather(*joint_state_msg, joint_state_msg->velocity, current_velocities_);
+      record_motion_start();
+      events |= TaskStates::kArmMoved;
+    } else {
+      ROS_WARN_THROTTLE(1, "Joint state does not contain all arm joints");
+    }
+  }
+  const bool attached = gripper_state_attatch_.load();
+  if (attached != was_attached_) {
+    events |= attached ? TaskStates::kPartAttached : TaskStates::kPartDetached;
+    was_attached_ = attached;
+  }
+  const bool confirmed = gripper_.confirmed();
+  if (confirmed && !was_confirmed_) {
+    events |= TaskStates::kGripperConfirmed;
+  }
+  was_confirmed_ = confirmed;
+  const size_t pending = task_engine_.pending();
+  if (pending > last_pending_) {
+    events |= TaskStates::kTaskQueued;
+  }
+  last_pending_ = pending;
+  const size_t tray_changes = trays_.changes();
+  if (tray_changes != last_tray_changes_) {
+    events |= TaskStates::kTrayChanged;
+    last_tray_changes_ = tray_changes;
+    const size_t kits = trays_.kits_submitted();
+    for (; last_kits_submitted_ < kits; ++last_kits_submitted_) {
+      dashboard_.kit_submitted(now);
+    }
+  }
+  const size_t fixes = conveyor_.fixes();
+  if (fixes != last_conveyor_fixes_) {
+    events |= TaskStates::kConveyorChanged;
+    last_conveyor_fixes_ = fixes;
+  }
+  return events;
+}
+
+ThroughputDashboard::Activity MyCompetitionClass::activity() const {
+  switch (state_machine_.state()) {
+    case TaskStates::kStartup:
+      return ThroughputDashboard::kStarting;
+    case TaskStates::kIdle:
+      if (!warm_.load()) {
+        return ThroughputDashboard::kStarting;
+      }
+      // Idle with tasks queued only lasts while their tray is away.
+      return task_engine_.pending() == 0 ? ThroughputDashboard::kNoOrder : ThroughputDashboard::kTrayAway;
+    case TaskStates::kMoveToBin:
+      // At the goal, only a missing or stale transform is a wait on TF; else the gripper is not in tolerance yet.
+      return arm_reached(task_.pick.grasp) && tf_missing_ ?
+        ThroughputDashboard::kTf : ThroughputDashboard::kMotion;
+    case TaskStates::kMoveToTray:
+      return arm_reached(task_.place_goal) && tf_missing_ ?
+        ThroughputDashboard::kTf : ThroughputDashboard::kMotion;
+    case TaskStates::kGraspBin:
+    case TaskStates::kRelease:
+      return ThroughputDashboard::kGripper;
+    case TaskStates::kWaitForPart:
+      return ThroughputDashboard::kSensors;
+    case TaskStates::kHoverOverBelt:
+      return arm_reached(task_.pick.approach) ? ThroughputDashboard::kSensors : ThroughputDashboard::kMotion;
+    default:
+      return ThroughputDashboard::kMotion;
+  }
+}
+
+void MyCompetitionClass::check_ready() {
+  if (state_machine_.state() != TaskStates::kStartup && arm_reached(waypoint_table_.ready())) {
+    milestone(StartupTracker::kArmReady);
+  }
+  geometry_msgs::Point gripper;
+  if (!startup_.reached(StartupTracker::kTfReady) && tf_cache_.lookup_origin(world_frames_, gripper)) {
+    milestone(StartupTracker::kTfReady);
+  }
+}
+
+TaskStates::State MyCompetitionClass::on(StateTag<TaskStates::kStartup>) {
+  send_arm_to_zero_state();
+  state_machine_.wake_at(ros::Time::now());  // An order may be waiting already.
+  return TaskStates::kIdle;
+}
+
+TaskStates::State MyCompetitionClass::on(StateTag<TaskStates::kIdle>) {
+  if (!task_engine_.front(task_)) {
+    return TaskStates::kNoState;  // Nothing to do until the next order arrives.
+  }
+  if (!warm_.load()) {
+    state_machine_.wake_at(ros::Time::now() + ros::Duration(0.1));
+    return TaskStates::kNoState;  // warm_up() is still filling the IK table.
+  }
+  if (!trays_.available(task_.agv, task_.kit)) {
+    ROS_INFO_THROTTLE(5, "Waiting for agv%d to come back", task_.agv);
+    return TaskStates::kNoState;  // Woken again when a tray changes phase.
+  }
+  const ros::Time now = ros::Time::now();
+  trays_.start_kit(task_, now);
+  dashboard_.part_started(now);
+  events_.log(EventLog::kTaskStarted, task_.part_type.c_str(), task_.bin, task_.agv, task_.tray_slot);
+  if (task_.bin == WaypointTable::kConveyor) {
+    state_machine_.wake_at(now);  // Look for a part on the belt on the next tick.
+    return TaskStates::kWaitForPart;
+  }
+  find_target_part();
+  // Go and pick the part up.
+  move_to("bin", {&task_.pick.approach, &task_.pick.grasp});
+  if (bin_move_timeout_ > 0.0) {
+    state_machine_.wake_at(now + ros::Duration(bin_move_timeout_));
+  }
+  return TaskStates::kMoveToBin;
+}
+
+TaskStates::State MyCompetitionClass::on(StateTag<TaskStates::kMoveToBin>) {
+  const ros::Time now = ros::Time::now();
+  if (grasp_bin(task_.bin)) {
+    if (bin_grasp_timeout_ > 0.0) {
+      state_machine_.wake_at(now + ros::Duration(bin_grasp_timeout_));
+    }
+    return TaskStates::kGraspBin;
+  }
+  return timed_out(TaskStates::kMoveToBin, bin_move_timeout_, now) ? retry_pick(now) : TaskStates::kNoState;
+}
+
+TaskStates::State MyCompetitionClass::on(StateTag<TaskStates::kGraspBin>) {
+  const ros::Time now = ros::Time::now();
+  if (gripper_state_attatch_.load() || !timed_out(TaskStates::kGraspBin, bin_grasp_timeout_, now)) {
+    return TaskStates::kNoState;
+  }
+  return retry_pick(now);
+}
+
+TaskStates::State MyCompetitionClass::on(StateTag<TaskStates::kPick>) {
+  if (!gripper_state_attatch_.load()) {
+    return TaskStates::kNoState;
+  }
+  pick_attempts_ = 0;
+  if (task_.bin == WaypointTable::kConveyor) {
+    conveyor_.remove(intercept_.part);
+  }
+  move_to("tray", {&task_.pick.approach, &task_.place_goal});
+  return TaskStates::kMoveToTray;
+}
+
+TaskStates::State MyCompetitionClass::on(StateTag<TaskStates::kWaitForPart>) {
+  const ros::Time now = ros::Time::now();
+  const TrajectoryTiming & timing = trajectory_builder_.timing();
+  const double kRetryInterval = 0.5;  // s between plans while no part comes along
+  // Plan twice: the first intercept gives the hover point, whose travel time moves the intercept.
+  PickWaypoints pick = task_.pick;
+  for (int pass = 0; pass < 2; ++pass) {
+    const ros::Time ready = now + ros::Duration(conveyor_lead_time_ +
+      timing.segment_time(current_positions_, pick.approach) + timing.segment_time(pick.approach, pick.grasp));
+    if (!conveyor_.intercept(task_.part_type, conveyor_untyped_, ready, conveyor_lead_time_, intercept_)) {
+      state_machine_.wake_at(now + ros::Duration(kRetryInterval));
+      return TaskStates::kNoState;  // Nothing on the belt that can be met yet.
+    }
+    const Vec3 & part = intercept_.position;
+    const Vec3 approach = {{part[0], part[1], part[2] + pick_approach_height_}};
+    if (!ik_table_.solve(approach, pick.approach) || !ik_table_.solve(part, pick.grasp)) {
+      ROS_WARN_THROTTLE(1, "No IK solution over the conveyor part");
+      state_machine_.wake_at(now + ros::Duration(kRetryInterval));
+      return TaskStates::kNoState;
+    }
+  }
+  task_.pick = pick;
+  events_.log(EventLog::kConveyorPick, task_.part_type.c_str(), intercept_.part, 1, 0,
+    (intercept_.time - now).toSec(), intercept_.position[1]);
+  move_to("conveyor", {&task_.pick.approach});
+  // Wake when it is time to go down, in case no joint state comes in then.
+  state_machine_.wake_at(intercept_.time - ros::Duration(timing.segment_time(pick.approach, pick.grasp)));
+  return TaskStates::kHoverOverBelt;
+}
+
+TaskStates::State MyCompetitionClass::on(StateTag<TaskStates::kHoverOverBelt>) {
+  const ros::Time now = ros::Time::now();
+  if (missed_conveyor_part(now)) {
+    return TaskStates::kWaitForPart;
+  }
+  const double descent = trajectory_builder_.timing().segment_time(task_.pick.approach, task_.pick.grasp);
+  if (!arm_reached(task_.pick.approach) || now + ros::Duration(descent) < intercept_.time) {
+    return TaskStates::kNoState;
+  }
+  move_to("conveyor part", {&task_.pick.grasp});
+  grasp_kit();
+  state_machine_.wake_at(intercept_.time + ros::Duration(conveyor_lead_time_));
+  return TaskStates::kMeetPart;
+}
+
+TaskStates::State MyCompetitionClass::on(StateTag<TaskStates::kMeetPart>) {
+  if (gripper_state_attatch_.load()) {
+    return TaskStates::kNoState;  // kPick carries it to the tray.
+  }
+  return missed_conveyor_part(ros::Time::now()) ? TaskStates::kWaitForPart : TaskStates::kNoState;
+}
+
+TaskStates::State MyCompetitionClass::on(StateTag<TaskStates::kMoveToTray>) {
+  if (!gripper_state_attatch_.load()) {
+    ROS_WARN_STREAM("Dropped the " << task_.part_type << " on the way to agv" << task_.agv << "; picking again");
+    release_kit();
+    state_machine_.wake_at(ros::Time::now());
+    return TaskStates::kIdle;
+  }
+  return arm_reached(task_.place_goal) && place_kit_tray(task_.agv) ?
+    TaskStates::kRelease : TaskStates::kNoState;
+}
+
+TaskStates::State MyCompetitionClass::on(StateTag<TaskStates::kRelease>) {
+  if (!gripper_.confirmed() || gripper_state_attatch_.load()) {
+    return TaskStates::kNoState;
+  }
+  const ros::Time now = ros::Time::now();
+  trays_.placed(task_.agv, now);
+  dashboard_.part_placed(now);
+  task_engine_.pop();
+  state_machine_.wake_at(now);
+  return TaskStates::kIdle;
+}
+
+void MyCompetitionClass::send_arm_to_zero_state() {
+  move_to("ready position", {&waypoint_table_.ready()});
+}
+
+void MyCompetitionClass::logical_camera_callback(const osrf_gear::LogicalCameraImage::ConstPtr & image_msg) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kLogicalCameraCallback);
+  //ROS_INFO_STREAM("Logical camera: '" << image_msg->models.size() << "' objects.");
+  part_index_.update(1, *image_msg);
+  conveyor_.camera(*image_msg, ros::Time::now());
+}
+
+void MyCompetitionClass::tray_logical_camera_callback(
+  const osrf_gear::LogicalCameraImage::ConstPtr & image_msg) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kTrayLogicalCameraCallback);
+  part_index_.update(2, *image_msg);
+  // Only count parts, not the tray and AGV models the camera also reports.
+  const int parts = part_index_.count(2);
+  if (tray_camera_agv_ > 0) {
+    trays_.seen(tray_camera_agv_, parts);
+  }
+  events_.log(EventLog::kTrayCamera, NULL, image_msg->models.size(), parts);
+}
+
+void MyCompetitionClass::move_to(const char * destination,
+                                 std::initializer_list<const JointPositions *> waypoints) {
+  // The builder fills its preallocated template in place, starting from where the arm is now.
+  trajectory_msgs::JointTrajectory & traj = check_collisions_ ?
+    trajectory_builder_.build(current_positions_, route(destination, waypoints)) :
+    trajectory_builder_.build(current_positions_, waypoints);
+  traj.header.stamp = ros::Time::now();
+  events_.log(EventLog::kArmCommand, destination, traj.points.size(), 0, 0,
+    traj.points.back().time_from_start.toSec());
+  transport_.publish_arm_command(traj);
+  if (state_machine_.state() != TaskStates::kStartup && !startup_.reached(StartupTracker::kFirstCommand)) {
+    milestone(StartupTracker::kFirstCommand);
+    if (startup_.reached(StartupTracker::kStarted)) {
+      instrumentation_.record(Instrumentation::kTimeToFirstCommand,
+        startup_.since_start(StartupTracker::kFirstCommand));
+    }
+  }
+  // Time from here until the joints start moving is recorded by record_motion_start().
+  command_start_ = current_positions_;
+  command_stamp_ = traj.header.stamp;
+  awaiting_motion_ = true;
+}
+
+void MyCompetitionClass::record_motion_start() {
+  if (!awaiting_motion_) {
+    return;
+  }
+  const double kMotionThreshold = 1e-3;  // rad (m for the rail) counted as moving
+  for (size_t i = 0; i < kNumArmJoints; ++i) {
+    if (std::abs(current_positions_[i] - command_start_[i]) > kMotionThreshold) {
+      instrumentation_.record(Instrumentation::kCommandToMotion, (ros::Time::now() - command_stamp_).toSec());
+      awaiting_motion_ = false;
+      return;
+    }
+  }
+}
+
+const std::vector<const JointPositions *> & MyCompetitionClass::route(
+  const char * destination, std::initializer_list<const JointPositions *> waypoints) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kCollisionCheck);
+  route_.clear();
+  size_t used = 0;
+  const JointPositions * previous = &current_positions_;
+  for (std::initializer_list<const JointPositions *>::const_iterator it = waypoints.begin();
+       it != waypoints.end(); ++it) {
+    const int count = used + 2 <= kMaxRouteWaypoints ?
+      collision_model_.route(*previous, **it, trajectory_builder_.timing(), &via_[used]) : 0;
+    if (count < 0) {
+      ROS_WARN_STREAM("No collision-free route to the " << destination << "; moving directly");
+    }
+    for (int i = 0; i < count; ++i) {
+      route_.push_back(&via_[used++]);
+    }
+    route_.push_back(*it);
+    previous = *it;
+  }
+  return route_;
+}
+
+void MyCompetitionClass::publish_diagnostics() {
+  if (diagnostics_period_ <= 0.0) {
+    return;
+  }
+  const ros::Time now = ros::Time::now();
+  if (!last_diagnostics_.isZero() && (now - last_diagnostics_).toSec() < diagnostics_period_) {
+    return;
+  }
+  last_diagnostics_ = now;
+  diagnostics_.header.stamp = now;
+  instrumentation_.fill(diagnostics_);
+  dashboard_.fill(diagnostics_, now);
+  transport_.publish_diagnostics(diagnostics_);
+}
+
+bool MyCompetitionClass::arm_reached(const JointPositions & goal) const {
+  return convergence_.reached(goal, current_positions_, has_velocities_ ? &current_velocities_ : NULL);
+}
+
+void MyCompetitionClass::break_beam_callback(const osrf_gear::Proximity::ConstPtr & msg) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kBreakBeamCallback);
+  conveyor_.break_beam(stamp_or_now(msg->header.stamp), msg->object_detected);
+  if (msg->object_detected) {  // If there is an object in proximity.
+    events_.log(EventLog::kBreakBeam, NULL);
+  }
+}
+
+void MyCompetitionClass::proximity_sensor_callback(const sensor_msgs::Range::ConstPtr & msg) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kProximitySensorCallback);
+  instrumentation_.record_age(Instrumentation::kSensorAge, msg->header.stamp);
+  const bool detected = (msg->max_range - msg->range) > 0.01;  // If there is an object in proximity.
+  conveyor_.proximity(stamp_or_now(msg->header.stamp), detected);
+  if (detected) {
+    events_.log(EventLog::kProximity, NULL);
+  }
+}
+
+void MyCompetitionClass::laser_profiler_callback(const sensor_msgs::LaserScan::ConstPtr & msg) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kLaserProfilerCallback);
+  instrumentation_.record_age(Instrumentation::kSensorAge, msg->header.stamp);
+  conveyor_.laser_scan(stamp_or_now(msg->header.stamp), *msg);
+  const size_t tracked = conveyor_.tracked();
+  if (tracked > 0) {
+    events_.log(EventLog::kLaserProfiler, NULL, tracked, 0, 0, conveyor_.speed());
+  }
+}
+
+void MyCompetitionClass::gripper_state_attatch_callback(
+  const osrf_gear::VacuumGripperState::ConstPtr & msg) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kGripperStateCallback);
+  gripper_state_attatch_.store(msg->attached);
+  gripper_.on_state(*msg);
+}
+
+void MyCompetitionClass::grasp_kit() {
+  // queued to the gripper worker; repeated requests are coalesced
+  gripper_.request(true);
+}
+
+void MyCompetitionClass::release_kit() {
+  // queued to the gripper worker; repeated requests are coalesced
+  gripper_.request(false);
+}
+
+bool MyCompetitionClass::under_tolerance(const geometry_msgs::Point& upper_bound,
+    const geometry_msgs::Point& lower_bound, const geometry_msgs::Point& relative_pose) {
+  if (relative_pose.x < upper_bound.x && relative_pose.x > lower_bound.x \
+      && relative_pose.y < upper_bound.y && relative_pose.y > lower_bound.y \
+      && relative_pose.z < upper_bound.z && relative_pose.z > lower_bound.z) {
+    return true;
+  } else {
+    return false;
+  }
+}
+
+bool MyCompetitionClass::under_tolerance(const geometry_msgs::Point& tolerance,
+    const geometry_msgs::Point& relative_pose) {
+  if ((std::abs(relative_pose.x) < tolerance.x) && (std::abs(relative_pose.y) < tolerance.y) \
+      && (std::abs(relative_pose.z) < tolerance.z)) {
+    return true;
+  } else {
+    return false;
+  }
+}
+
+bool MyCompetitionClass::lookup_origin(int pair, geometry_msgs::Point & origin) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kTfLookup);
+  tf_missing_ = !tf_cache_.lookup_origin(pair, origin);
+  return !tf_missing_;
+}
+
+bool MyCompetitionClass::gripper_near(int pair, const geometry_msgs::Point& tolerance) {
+  geometry_msgs::Point relative_pose;	///< the relative position between gripper and frame
+  if (!lookup_origin(pair, relative_pose)) {
+    ROS_WARN_THROTTLE(1, "No fresh transform for the vacuum gripper yet");
+    return false;
+  }
+  return under_tolerance(tolerance, relative_pose);
+}
+
+bool MyCompetitionClass::grasp_bin(int bin) {
+  if (has_target_part_) {
+    // Picking with IK: grasp when the gripper is over the part the camera located.
+    geometry_msgs::Point gripper;
+    if (lookup_origin(world_frames_, gripper)) {
+      geometry_msgs::Point relative_pose;
+      relative_pose.x = gripper.x - target_part_.pose.position.x;
+      relative_pose.y = gripper.y - target_part_.pose.position.y;
+      relative_pose.z = gripper.z - target_part_.pose.position.z;
+      if (under_tolerance(bin_tolerance_, relative_pose)) {
+        grasp_kit();
+        return true;
+      }
+    }
+    return false;
+  }
+  std::map<int, int>::const_iterator frames = bin_frames_.find(bin);
+  // if the relative position under tolerance enable the vacuum gripper
+  if (frames != bin_frames_.end() && gripper_near(frames->second, bin_tolerance_)) {
+    grasp_kit();
+    return true;
+  }
+  return false;
+}
+
+void MyCompetitionClass::find_target_part() {
+  has_target_part_ = false;
+  if (!ik_picks_) {
+    return;
+  }
+  ToolPose grasp;
+  ik_table_.kinematics().forward(task_.pick.grasp, grasp);
+  geometry_msgs::Point from;
+  from.x = grasp.position[0];
+  from.y = grasp.position[1];
+  from.z = grasp.position[2];
+  const bool found = part_index_.nearest(task_.part_type, from, part_reach_, 1, target_part_);
+  events_.log(EventLog::kTargetPart, task_.part_type.c_str(), task_.bin, found, 0,
+    target_part_.pose.position.x, target_part_.pose.position.y);
+  has_target_part_ = found && plan_pick();
+}
+
+bool MyCompetitionClass::missed_conveyor_part(const ros::Time & now) {
+  if (now < intercept_.time + ros::Duration(conveyor_lead_time_)) {
+    return false;
+  }
+  events_.log(EventLog::kConveyorPick, task_.part_type.c_str(), intercept_.part, 0, 0,
+    (intercept_.time - now).toSec(), intercept_.position[1]);
+  release_kit();
+  conveyor_.remove(intercept_.part);
+  state_machine_.wake_at(now);
+  return true;
+}
+
+bool MyCompetitionClass::timed_out(TaskStates::State state, double timeout, const ros::Time & now) const {
+  return timeout > 0.0 && (now - state_machine_.entered(state)).toSec() >= timeout;
+}
+
+TaskStates::State MyCompetitionClass::retry_pick(const ros::Time & now) {
+  state_machine_.time_out();
+  release_kit();
+  state_machine_.wake_at(now);  // Start again, or on the next task, on the next tick.
+  if (++pick_attempts_ <= pick_retries_) {
+    ROS_WARN_STREAM("No " << task_.part_type << " picked from bin " << task_.bin << " in time; planning again");
+    return TaskStates::kIdle;
+  }
+  ROS_WARN_STREAM("No " << task_.part_type << " picked from bin " << task_.bin << " after "
+    << pick_attempts_ << " tries; skipping it");
+  pick_attempts_ = 0;
+  trays_.skipped(task_.agv, now);
+  task_engine_.pop();
+  return TaskStates::kIdle;
+}
+
+ros::Time MyCompetitionClass::stamp_or_now(const ros::Time & stamp) {
+  return stamp.isZero() ? ros::Time::now() : stamp;
+}
+
+bool MyCompetitionClass::plan_pick() {
+  const geometry_msgs::Point & part = target_part_.pose.position;
+  const Vec3 approach = {{part.x, part.y, part.z + pick_approach_height_}};
+  const Vec3 grasp = {{part.x, part.y, part.z + pick_grasp_height_}};
+  PickWaypoints pick;
+  if (!ik_table_.solve(approach, pick.approach) || !ik_table_.solve(grasp, pick.grasp)) {
+    ROS_WARN_STREAM("No IK solution over the " << task_.part_type << ", using the bin waypoints");
+    return false;
+  }
+  task_.pick = pick;
+  return true;
+}
+
+bool MyCompetitionClass::place_kit_tray(int agv) {
+  std::map<int, int>::const_iterator frames = tray_frames_.find(agv);
+  // if the relative position under tolerance disable the vacuum gripper
+  if (frames != tray_frames_.end() && gripper_near(frames->second, tray_tolerance_)) {
+    release_kit();
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,67 @@
+#include "ariac_example/competition_config.h"
+
+CompetitionConfig::CompetitionConfig()
+: tf_max_age(0.5), part_reach(0.5), limit_scale(0.5), min_segment_time(0.1),
+  settle_velocity(0.0), gripper_timeout(1.0), listen_tf(true), gripper_worker(true),
+  diagnostics_period(1.0), event_console(true), ik_resolution(0.05), ik_picks(false),
+  pick_approach_height(0.2), pick_grasp_height(0.03), bin_move_timeout(15.0), bin_grasp_timeout(3.0),
+  pick_retries(1), plan_time_budget(0.01), plan_exact_limit(10),
+  check_collisions(true), conveyor_untyped(true), conveyor_lead_time(0.5), agvs({1}),
+  agv_transit_time(20.0), tray_camera_agv(1), dashboard_period(1.0),
+  dashboard_samples(4096)
+{
+  part_bins["piston_rod_part"] = 7;
+  part_bins["gear_part"] = 6;
+}
+
+void CompetitionConfig::load(const ros::NodeHandle & private_node) {
+  std::map<std::string, int> bins;
+  if (private_node.getParam("part_bins", bins)) {
+    part_bins = bins;
+  }
+  private_node.param("tf_max_age", tf_max_age, tf_max_age);
+  private_node.param("part_reach", part_reach, part_reach);
+  private_node.param("limit_scale", limit_scale, limit_scale);
+  private_node.param("min_segment_time", min_segment_time, min_segment_time);
+  private_node.getParam("max_joint_velocity", max_joint_velocity);
+  private_node.getParam("max_joint_acceleration", max_joint_acceleration);
+  private_node.getParam("goal_tolerance", goal_tolerance);
+  private_node.param("settle_velocity", settle_velocity, settle_velocity);
+  private_node.param("gripper_timeout", gripper_timeout, gripper_timeout);
+  private_node.param("diagnostics_period", diagnostics_period, diagnostics_period);
+  private_node.param("metrics_file", metrics_file, metrics_file);
+  private_node.param("event_log_file", event_log_file, event_log_file);
+  private_node.param("event_console", event_console, event_console);
+  private_node.getParam("arm_base", arm_base);
+  private_node.param("ik_resolution", ik_resolution, ik_resolution);
+  private_node.param("ik_picks", ik_picks, ik_picks);
+  private_node.param("pick_approach_height", pick_approach_height, pick_approach_height);
+  private_node.param("pick_grasp_height", pick_grasp_height, pick_grasp_height);
+  private_node.param("bin_move_timeout", bin_move_timeout, bin_move_timeout);
+  private_node.param("bin_grasp_timeout", bin_grasp_timeout, bin_grasp_timeout);
+  private_node.param("pick_retries", pick_retries, pick_retries);
+  private_node.param("plan_time_budget", plan_time_budget, plan_time_budget);
+  private_node.param("plan_exact_limit", plan_exact_limit, plan_exact_limit);
+  private_node.param("check_collisions", check_collisions, check_collisions);
+  XmlRpc::XmlRpcValue boxes;
+  if (private_node.getParam("obstacles", boxes) && boxes.getType() == XmlRpc::XmlRpcValue::TypeStruct) {
+    obstacles.clear();
+    for (XmlRpc::XmlRpcValue::iterator it = boxes.begin(); it != boxes.end(); ++it) {
+      std::vector<double> & bounds = obstacles[it->first];
+      for (int i = 0; it->second.getType() == XmlRpc::XmlRpcValue::TypeArray && i < it->second.size(); ++i) {
+        XmlRpc::XmlRpcValue & value = it->second[i];
+        bounds.push_back(value.getType() == XmlRpc::XmlRpcValue::TypeInt ?
+          static_cast<int>(value) : static_cast<double>(value));
+      }
+    }
+  }
+  private_node.getParam("conveyor_pick_window", conveyor_pick_window);
+  private_node.param("conveyor_untyped", conveyor_untyped, conveyor_untyped);
+  private_node.param("conveyor_lead_time", conveyor_lead_time, conveyor_lead_time);
+  private_node.getParam("agvs", agvs);
+  private_node.param("agv_transit_time", agv_transit_time, agv_transit_time);
+  private_node.param("tray_camera_agv", tray_camera_agv, tray_camera_agv);
+  private_node.param("dashboard_file", dashboard_file, dashboard_file);
+  private_node.param("dashboard_period", dashboard_period, dashboard_period);
+  private_node.param("dashboard_samples", dashboard_samples, dashboard_samples);
+}
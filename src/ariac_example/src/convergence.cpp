@@ -0,0 +1,55 @@
+#include "ariac_example/convergence.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ros/ros.h>
+
+ConvergenceCheck::ConvergenceCheck()
+: settle_velocity_(0.0)
+{
+  tolerance_.fill(0.05);
+}
+
+bool ConvergenceCheck::set_position_tolerance(const std::vector<double> & tolerance) {
+  if (tolerance.size() != kNumArmJoints) {
+    ROS_ERROR_STREAM("Ignoring goal tolerance: expected " << kNumArmJoints << " values.");
+    return false;
+  }
+  for (size_t i = 0; i < kNumArmJoints; ++i) {
+    if (tolerance[i] <= 0.0) {
+      ROS_ERROR_STREAM("Ignoring goal tolerance: value " << i << " is not positive.");
+      return false;
+    }
+  }
+  std::copy(tolerance.begin(), tolerance.end(), tolerance_.begin());
+  return true;
+}
+
+bool ConvergenceCheck::converged(const JointPositions & goal, const JointPositions & position) const {
+  // Count the joints that are out of tolerance instead of returning early.
+  int outside = 0;
+  for (size_t i = 0; i < kNumArmJoints; ++i) {
+    outside += std::fabs(goal[i] - position[i]) >= tolerance_[i];
+  }
+  return outside == 0;
+}
+
+bool ConvergenceCheck::settled(const JointPositions & velocity) const {
+  int moving = 0;
+  for (size_t i = 0; i < kNumArmJoints; ++i) {
+    moving += std::fabs(velocity[i]) >= settle_velocity_;
+  }
+  return moving == 0;
+}
+
+bool ConvergenceCheck::reached(const JointPositions & goal, const JointPositions & position,
+                               const JointPositions * velocity) const {
+  if (!converged(goal, position)) {
+    return false;
+  }
+  if (!uses_velocity()) {
+    return true;
+  }
+  // Without velocities there is nothing to wait for.
+  return velocity == NULL || settled(*velocity);
+}
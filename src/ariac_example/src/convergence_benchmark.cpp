@@ -0,0 +1,84 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ariac_example/convergence.h"
+
+/*
+ * Benchmark for the convergence check: time per check for the position
+ * test and the full test with the settle condition, against the isclose()
+ * loop it replaced (early exit, 0.05 on every joint), on random positions
+ * around a goal, about half of them converged.
+ *
+ * Usage: ariac_example_convergence_benchmark [checks]
+ */
+
+namespace {
+
+/// The old test, with std::fabs so it gives the right answer.
+bool isclose(const JointPositions & goal, const JointPositions & position) {
+  for (size_t i = 0; i < kNumArmJoints; ++i) {
+    if (std::fabs(goal[i] - position[i]) >= 0.05) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class Check>
+double time_checks(const char * name, size_t checks, Check check) {
+  size_t passed = 0;
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < checks; ++i) {
+    passed += check(i);
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(2)
+            << std::setw(10) << 1e9 * elapsed.count() / checks << std::setw(12) << passed << "\n";
+  return elapsed.count();
+}
+
+}  // namespace
+
+int main(int argc, char ** argv) {
+  const int checks = argc > 1 ? std::atoi(argv[1]) : 10000000;
+  if (checks <= 0) {
+    std::cerr << "Usage: " << argv[0] << " [checks]" << std::endl;
+    return 1;
+  }
+
+  // A pool of positions, each joint within 0.055 of the goal: about half of them converged.
+  const size_t kPool = 4096;
+  std::mt19937 random(5);
+  std::uniform_real_distribution<double> error(-0.055, 0.055);
+  JointPositions goal;
+  goal.fill(1.0);
+  std::vector<JointPositions> positions(kPool), velocities(kPool);
+  for (size_t i = 0; i < kPool; ++i) {
+    for (size_t j = 0; j < kNumArmJoints; ++j) {
+      positions[i][j] = goal[j] + error(random);
+      velocities[i][j] = error(random);
+    }
+  }
+
+  ConvergenceCheck position_only;
+  ConvergenceCheck settle;
+  settle.set_settle_velocity(0.05);
+
+  std::cout << std::left << std::setw(20) << "check" << std::right << std::setw(10) << "ns" << std::setw(12)
+            << "passed" << "\n";
+  time_checks("isclose (old)", checks, [&](size_t i) {
+    return isclose(goal, positions[i % kPool]);
+  });
+  time_checks("converged", checks, [&](size_t i) {
+    return position_only.converged(goal, positions[i % kPool]);
+  });
+  time_checks("reached + settled", checks, [&](size_t i) {
+    return settle.reached(goal, positions[i % kPool], &velocities[i % kPool]);
+  });
+  return 0;
+}
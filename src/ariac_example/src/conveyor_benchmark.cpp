@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "ariac_example/conveyor_tracker.h"
+
+/*
+ * Benchmark for the conveyor tracker on a simulated belt: parts of known
+ * size ride past the laser profiler, proximity sensor and break beam at a
+ * speed the tracker is not told, and intercepts are checked against where
+ * the parts really are at the intercept time. Also times the laser pass.
+ *
+ * Usage: ariac_example_conveyor_benchmark [parts] [belt speed (m/s)]
+ */
+
+namespace {
+
+const double kLaserY = 4.0, kProximityY = 2.6, kBreakBeamY = 2.25;
+const double kLaserZ = 1.64, kBeltTop = 0.91;
+const double kSpawnY = 4.6, kPartLength = 0.1, kPartWidth = 0.1, kPartHeight = 0.04;
+
+/// Whether a part centred at y covers a point sensor at sensor_y.
+bool covers(double y, double sensor_y) {
+  return std::abs(y - sensor_y) <= 0.5 * kPartLength;
+}
+
+/// Fill a scan across the belt, with the part under the profiler if it covers it.
+void scan(double part_y, sensor_msgs::LaserScan & msg) {
+  const bool under = covers(part_y, kLaserY);
+  for (size_t i = 0; i < msg.ranges.size(); ++i) {
+    const double angle = msg.angle_min + i * msg.angle_increment;
+    const double belt = (kLaserZ - kBeltTop) / std::cos(angle);
+    const double lateral = belt * std::sin(angle);
+    if (std::abs(lateral) > 0.3) {
+      msg.ranges[i] = std::numeric_limits<float>::infinity();  // past the belt edge
+    } else if (under && std::abs(lateral) < 0.5 * kPartWidth) {
+      msg.ranges[i] = static_cast<float>((kLaserZ - kBeltTop - kPartHeight) / std::cos(angle));
+    } else {
+      msg.ranges[i] = static_cast<float>(belt);
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char ** argv) {
+  const int parts = argc > 1 ? std::atoi(argv[1]) : 20;
+  const double speed = argc > 2 ? std::atof(argv[2]) : 0.23;
+  if (parts <= 0 || speed <= 0.0) {
+    std::cerr << "Usage: " << argv[0] << " [parts] [belt speed (m/s)]" << std::endl;
+    return 1;
+  }
+
+  ConveyorTracker tracker;
+  sensor_msgs::LaserScan msg;
+  msg.angle_min = -0.6f;
+  msg.angle_increment = 0.003f;
+  msg.range_min = 0.1f;
+  msg.range_max = 2.0f;
+  msg.ranges.resize(400);
+
+  // Parts spawn every 4 s; the sensors run at 100 Hz.
+  const double spawn_period = 4.0, dt = 0.01;
+  const double end = parts * spawn_period + 20.0;
+  // Errors on the first part, met before any speed sample, are kept apart.
+  double error_sum = 0.0, error_max = 0.0, first_max = 0.0;
+  int intercepts = 0;
+  for (double t = 1.0; t < end; t += dt) {
+    const ros::Time stamp(t);
+    // Parts are spaced well apart, so each sensor covers at most one of them.
+    double near_laser = 1e9, near_proximity = 1e9, near_beam = 1e9;
+    for (int p = 0; p < parts && t >= 1.0 + p * spawn_period; ++p) {
+      const double y = kSpawnY - speed * (t - 1.0 - p * spawn_period);
+      near_laser = covers(y, kLaserY) ? y : near_laser;
+      near_proximity = covers(y, kProximityY) ? y : near_proximity;
+      near_beam = covers(y, kBreakBeamY) ? y : near_beam;
+    }
+    msg.header.stamp = stamp;
+    scan(near_laser, msg);
+    tracker.laser_scan(msg.header.stamp, msg);
+    tracker.proximity(stamp, near_proximity < 1e8);
+    tracker.break_beam(stamp, near_beam < 1e8);
+
+    // Once a second, ask where a part can be met 2 s from now and check it against the truth.
+    if (std::fmod(t, 1.0) < dt) {
+      ConveyorIntercept intercept;
+      if (tracker.intercept("", true, stamp + ros::Duration(2.0), 0.5, intercept)) {
+        double best = 1e9;
+        for (int p = 0; p < parts; ++p) {
+          const double y = kSpawnY - speed * (intercept.time.toSec() - 1.0 - p * spawn_period);
+          best = std::min(best, std::abs(y - intercept.position[1]));
+        }
+        if (intercept.part == 0) {
+          first_max = std::max(first_max, best);
+          continue;
+        }
+        error_sum += best;
+        error_max = std::max(error_max, best);
+        ++intercepts;
+      }
+    }
+  }
+  std::cout << "belt speed " << speed << " m/s, estimated " << tracker.speed() << " m/s" << std::endl;
+  if (intercepts > 0) {
+    std::cout << "intercepts: " << intercepts << ", position error mean " << 1e3 * error_sum / intercepts
+              << " mm, max " << 1e3 * error_max << " mm (first part: max " << 1e3 * first_max << " mm)"
+              << std::endl;
+  }
+
+  const int scans = 100000;
+  scan(kLaserY, msg);
+  msg.header.stamp = ros::Time(end);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < scans; ++i) {
+    tracker.laser_scan(msg.header.stamp, msg);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "laser pass: " << 1e9 * elapsed.count() / scans << " ns per " << msg.ranges.size()
+            << "-ray scan" << std::endl;
+  return 0;
+}
@@ -0,0 +1,348 @@
+#include "ariac_example/conveyor_tracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tf/transform_datatypes.h>
+
+#include "ariac_example/part_index.h"
+
+namespace {
+
+// A ray counts as a hit this far above the belt; less is belt noise.
+const float kMinPartHeight = 0.005f;
+// Assumed for parts the laser did not profile.
+const double kDefaultPartHeight = 0.03;
+// Speed samples are blended in with this weight; implausible ones are ignored.
+const double kSpeedGain = 0.3;
+const double kMinSpeed = 0.02;
+const double kMaxSpeed = 2.0;
+// Sensor crossings are matched to parts predicted within this distance, or a
+// quarter of the way travelled since their last fix if that is more.
+const double kMatchDistance = 0.3;
+// Camera parts are on the belt when this close to its centre line and surface.
+const double kBeltHalfWidth = 0.35;
+const double kBeltCameraHeight = 0.2;
+// Independent accumulators in the laser pass; a multiple of the SIMD width.
+const size_t kLanes = 8;
+
+}  // namespace
+
+ConveyorTracker::ConveyorTracker()
+: belt_x_(1.21), belt_top_(0.91), direction_(-1.0), end_y_(-4.0), pick_min_y_(-1.0),
+  pick_max_y_(1.5), laser_z_(1.64), speed_(0.2), next_id_(0), fixes_(0), laser_part_(-1),
+  ray_angle_min_(0.0f), ray_increment_(0.0f), proximity_detected_(false), break_beam_detected_(false)
+{
+  sensor_y_[kLaserProfiler] = 4.0;
+  sensor_y_[kProximity] = 2.6;
+  sensor_y_[kBreakBeam] = 2.25;
+  sensor_y_[kCamera] = 0.0;  // not a fixed point; camera parts carry their own y
+  used_.fill(false);
+}
+
+void ConveyorTracker::set_sensor_y(Sensor sensor, double y) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sensor_y_[sensor] = y;
+}
+
+void ConveyorTracker::set_belt(double x, double top, double direction, double end_y) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  belt_x_ = x;
+  belt_top_ = top;
+  direction_ = direction < 0.0 ? -1.0 : 1.0;
+  end_y_ = end_y;
+}
+
+void ConveyorTracker::set_pick_window(double min_y, double max_y) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pick_min_y_ = std::min(min_y, max_y);
+  pick_max_y_ = std::max(min_y, max_y);
+}
+
+void ConveyorTracker::laser_scan(const ros::Time & stamp, const sensor_msgs::LaserScan & scan) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const size_t n = scan.ranges.size();
+  if (ray_cos_.size() != n || ray_angle_min_ != scan.angle_min || ray_increment_ != scan.angle_increment) {
+    // Only on the first scan, or if the profiler is reconfigured.
+    ray_cos_.resize(n);
+    ray_sin_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      const double angle = scan.angle_min + i * scan.angle_increment;
+      ray_cos_[i] = static_cast<float>(std::cos(angle));
+      ray_sin_[i] = static_cast<float>(std::sin(angle));
+    }
+    ray_angle_min_ = scan.angle_min;
+    ray_increment_ = scan.angle_increment;
+  }
+
+  // One pass: a ray hits a part when it stops short of the belt. NaN and inf
+  // ranges fail the comparison, so they need no separate test. Each of
+  // kLanes accumulators takes every kLanes-th ray, so the loop vectorises
+  // without reordering the float min/max reductions.
+  const float limit = static_cast<float>(laser_z_ - belt_top_) - kMinPartHeight;
+  const float range_min = scan.range_min;
+  const float far = std::numeric_limits<float>::max();
+  const float * r = scan.ranges.data();
+  const float * c = ray_cos_.data();
+  const float * s = ray_sin_.data();
+  float hits[kLanes], top[kLanes], lower[kLanes], upper[kLanes];
+  for (size_t k = 0; k < kLanes; ++k) {
+    hits[k] = 0.0f;
+    top[k] = far;
+    lower[k] = far;
+    upper[k] = -far;
+  }
+  size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    for (size_t k = 0; k < kLanes; ++k) {
+      const float drop = r[i + k] * c[i + k];
+      const float lateral = r[i + k] * s[i + k];
+      const bool hit = (drop < limit) & (r[i + k] >= range_min);
+      hits[k] += hit ? 1.0f : 0.0f;
+      top[k] = std::min(top[k], hit ? drop : far);
+      lower[k] = std::min(lower[k], hit ? lateral : far);
+      upper[k] = std::max(upper[k], hit ? lateral : -far);
+    }
+  }
+  for (; i < n; ++i) {
+    const float drop = r[i] * c[i];
+    const float lateral = r[i] * s[i];
+    const bool hit = (drop < limit) & (r[i] >= range_min);
+    hits[0] += hit ? 1.0f : 0.0f;
+    top[0] = std::min(top[0], hit ? drop : far);
+    lower[0] = std::min(lower[0], hit ? lateral : far);
+    upper[0] = std::max(upper[0], hit ? lateral : -far);
+  }
+  Profile profile = {0.0f, far, far, -far};
+  for (size_t k = 0; k < kLanes; ++k) {
+    profile.hits += hits[k];
+    profile.top = std::min(profile.top, top[k]);
+    profile.lower = std::min(profile.lower, lower[k]);
+    profile.upper = std::max(profile.upper, upper[k]);
+  }
+
+  const double laser_y = sensor_y_[kLaserProfiler];
+  if (profile.hits > 0.0f) {
+    if (laser_part_ < 0) {
+      // Leading edge under the profiler.
+      const size_t i = add(kLaserProfiler, laser_y, stamp);
+      laser_part_ = parts_[i].id;
+      laser_start_ = stamp;
+    }
+    for (size_t i = 0; i < kMaxParts; ++i) {
+      if (used_[i] && parts_[i].id == laser_part_) {
+        parts_[i].height = std::max(parts_[i].height, laser_z_ - profile.top - belt_top_);
+        parts_[i].x = belt_x_ + 0.5 * (profile.lower + profile.upper);
+      }
+    }
+  } else if (laser_part_ >= 0) {
+    // Trailing edge: the whole part has passed, so its length and centre are known.
+    for (size_t i = 0; i < kMaxParts; ++i) {
+      if (used_[i] && parts_[i].id == laser_part_) {
+        parts_[i].length = speed_ * (stamp - laser_start_).toSec();
+        parts_[i].y = laser_y + direction_ * 0.5 * parts_[i].length;
+        parts_[i].stamp = stamp;
+      }
+    }
+    laser_part_ = -1;
+  }
+  expire(stamp);
+}
+
+void ConveyorTracker::proximity(const ros::Time & stamp, bool detected) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (detected && !proximity_detected_) {
+    crossing(kProximity, stamp);
+  }
+  proximity_detected_ = detected;
+  expire(stamp);
+}
+
+void ConveyorTracker::break_beam(const ros::Time & stamp, bool detected) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (detected && !break_beam_detected_) {
+    crossing(kBreakBeam, stamp);
+  }
+  break_beam_detected_ = detected;
+  expire(stamp);
+}
+
+void ConveyorTracker::camera(const osrf_gear::LogicalCameraImage & image, const ros::Time & stamp) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tf::Transform camera_pose;
+  tf::poseMsgToTF(image.pose, camera_pose);
+  for (size_t m = 0; m < image.models.size(); ++m) {
+    const osrf_gear::Model & model = image.models[m];
+    if (!PartIndex::is_part(model.type)) {
+      continue;
+    }
+    tf::Transform model_pose;
+    tf::poseMsgToTF(model.pose, model_pose);
+    const tf::Vector3 position = (camera_pose * model_pose).getOrigin();
+    if (std::abs(position.x() - belt_x_) > kBeltHalfWidth ||
+        std::abs(position.z() - belt_top_) > kBeltCameraHeight) {
+      continue;  // Not on the belt.
+    }
+    int i = match(position.y(), stamp, kMatchDistance, false);
+    if (i < 0) {
+      i = static_cast<int>(add(kCamera, position.y(), stamp));
+    } else {
+      fix(i, kCamera, position.y(), stamp);
+    }
+    parts_[i].type = model.type;
+    parts_[i].x = position.x();
+  }
+  expire(stamp);
+}
+
+double ConveyorTracker::speed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return speed_;
+}
+
+bool ConveyorTracker::part(int id, ConveyorPart & part) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < kMaxParts; ++i) {
+    if (used_[i] && parts_[i].id == id) {
+      part = parts_[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ConveyorTracker::intercept(const std::string & type, bool accept_untyped, const ros::Time & ready,
+                                double margin, ConveyorIntercept & intercept) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // The window along the belt direction: parts enter at one end and leave at the other.
+  const double enter = std::min(direction_ * pick_min_y_, direction_ * pick_max_y_);
+  const double leave = std::max(direction_ * pick_min_y_, direction_ * pick_max_y_);
+  bool found = false;
+  for (size_t i = 0; i < kMaxParts; ++i) {
+    const ConveyorPart & part = parts_[i];
+    if (!used_[i] || !(part.type == type || (accept_untyped && part.type.empty()))) {
+      continue;
+    }
+    // Time from the part's last fix to entering and leaving the window.
+    const double along = direction_ * part.y;
+    const ros::Time enters = part.stamp + ros::Duration(std::max(0.0, (enter - along) / speed_));
+    const ros::Time leaves = part.stamp + ros::Duration((leave - along) / speed_);
+    const ros::Time meet = std::max(ready, enters);
+    if (meet + ros::Duration(margin) > leaves || (found && meet >= intercept.time)) {
+      continue;
+    }
+    intercept.part = part.id;
+    intercept.time = meet;
+    intercept.position[0] = part.x;
+    intercept.position[1] = direction_ * travelled(i, meet);
+    intercept.position[2] = belt_top_ + (part.height > 0.0 ? part.height : kDefaultPartHeight);
+    found = true;
+  }
+  return found;
+}
+
+void ConveyorTracker::remove(int id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < kMaxParts; ++i) {
+    if (used_[i] && parts_[i].id == id) {
+      used_[i] = false;
+    }
+  }
+}
+
+size_t ConveyorTracker::tracked() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::count(used_.begin(), used_.end(), true);
+}
+
+size_t ConveyorTracker::fixes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return fixes_;
+}
+
+int ConveyorTracker::crossing(Sensor sensor, const ros::Time & stamp) {
+  const double y = sensor_y_[sensor];
+  int i = match(y, stamp, kMatchDistance, true);
+  if (i < 0) {
+    // Missed upstream: it starts here.
+    i = static_cast<int>(add(sensor, y, stamp));
+  }
+  // The sensor sees the leading edge; the centre is half a length upstream.
+  fix(i, sensor, y - direction_ * 0.5 * parts_[i].length, stamp);
+  return parts_[i].id;
+}
+
+int ConveyorTracker::match(double y, const ros::Time & stamp, double max_distance, bool upstream_only) const {
+  int best = -1;
+  double best_distance = 0.0;
+  for (size_t i = 0; i < kMaxParts; ++i) {
+    if (!used_[i]) {
+      continue;
+    }
+    const ConveyorPart & part = parts_[i];
+    // A point sensor can only see parts last fixed upstream of it.
+    if (upstream_only && direction_ * (y - part.y) <= 0.0) {
+      continue;
+    }
+    const double predicted = direction_ * travelled(i, stamp);
+    const double distance = std::abs(predicted - y);
+    const double allowed = std::max(max_distance, 0.25 * std::abs(predicted - part.y));
+    if (distance < allowed && (best < 0 || distance < best_distance)) {
+      best = static_cast<int>(i);
+      best_distance = distance;
+    }
+  }
+  return best;
+}
+
+void ConveyorTracker::fix(size_t i, Sensor sensor, double y, const ros::Time & stamp) {
+  ConveyorPart & part = parts_[i];
+  const double dt = (stamp - part.stamp).toSec();
+  if (part.sensor != sensor && dt > 0.0) {
+    const double sample = direction_ * (y - part.y) / dt;
+    if (sample > kMinSpeed && sample < kMaxSpeed) {
+      speed_ += kSpeedGain * (sample - speed_);
+    }
+  }
+  part.sensor = sensor;
+  part.y = y;
+  part.stamp = stamp;
+  ++fixes_;
+}
+
+size_t ConveyorTracker::add(Sensor sensor, double y, const ros::Time & stamp) {
+  size_t slot = 0;
+  for (size_t i = 0; i < kMaxParts; ++i) {
+    if (!used_[i]) {
+      slot = i;
+      break;
+    }
+    if (parts_[i].stamp < parts_[slot].stamp) {
+      slot = i;
+    }
+  }
+  ConveyorPart & part = parts_[slot];
+  part.id = next_id_++;
+  part.type.clear();
+  part.sensor = sensor;
+  part.stamp = stamp;
+  part.y = y;
+  part.x = belt_x_;
+  part.height = 0.0;
+  part.length = 0.0;
+  used_[slot] = true;
+  ++fixes_;
+  return slot;
+}
+
+void ConveyorTracker::expire(const ros::Time & stamp) {
+  for (size_t i = 0; i < kMaxParts; ++i) {
+    if (used_[i] && parts_[i].id != laser_part_ && travelled(i, stamp) > direction_ * end_y_) {
+      used_[i] = false;
+    }
+  }
+}
+
+double ConveyorTracker::travelled(size_t i, const ros::Time & stamp) const {
+  return direction_ * parts_[i].y + speed_ * (stamp - parts_[i].stamp).toSec();
+}
@@ -0,0 +1,250 @@
+#include "ariac_example/event_log.h"
+
+#include <chrono>
+#include <cstring>
+#include <sstream>
+
+namespace {
+
+const char kMagic[8] = {'A', 'R', 'I', 'A', 'C', 'E', 'V', 'T'};
+const uint32_t kVersion = 2;  // bumped whenever a type or its payload layout changes
+
+size_t round_up_pow2(size_t n) {
+  size_t size = 2;
+  while (size < n) {
+    size <<= 1;
+  }
+  return size;
+}
+
+}  // namespace
+
+EventLog::EventLog(size_t capacity, bool console)
+: cells_(new Cell[round_up_pow2(capacity)]), mask_(round_up_pow2(capacity) - 1),
+  enqueue_pos_(0), dequeue_pos_(0), dropped_(0), reported_dropped_(0), console_(console),
+  state_names_(NULL), running_(true)
+{
+  for (size_t i = 0; i <= mask_; ++i) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  for (int i = 0; i < kNumTypes; ++i) {
+    min_interval_ns_[i].store(0, std::memory_order_relaxed);
+    next_allowed_ns_[i].store(0, std::memory_order_relaxed);
+  }
+  // Defaults for the sources that fire on every frame.
+  set_rate_limit(kJointState, 10.0);
+  set_rate_limit(kTrayCamera, 1.0);
+  set_rate_limit(kProximity, 1.0);
+  set_rate_limit(kLaserProfiler, 1.0);
+  worker_ = std::thread(&EventLog::run, this);
+}
+
+EventLog::~EventLog() {
+  running_.store(false);
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+bool EventLog::open(const std::string & path) {
+  // Only called before anything is logged, while the drain thread finds the ring empty.
+  file_.open(path.c_str(), std::ios::binary | std::ios::trunc);
+  if (!file_) {
+    ROS_ERROR_STREAM("Could not open event log " << path);
+    return false;
+  }
+  write_header(file_);
+  return true;
+}
+
+void EventLog::set_rate_limit(Type type, double seconds) {
+  min_interval_ns_[type].store(seconds > 0.0 ? static_cast<uint64_t>(seconds * 1e9) : 0,
+                               std::memory_order_relaxed);
+}
+
+bool EventLog::log(Type type, const char * text, int32_t a, int32_t b, int32_t c,
+                   double x, double y, double z) {
+  const uint64_t now = ros::Time::now().toNSec();
+  const uint64_t interval = min_interval_ns_[type].load(std::memory_order_relaxed);
+  if (interval > 0) {
+    // Claim the slot; whoever loses the race drops its event.
+    uint64_t next = next_allowed_ns_[type].load(std::memory_order_relaxed);
+    if (now < next ||
+        !next_allowed_ns_[type].compare_exchange_strong(next, now + interval, std::memory_order_relaxed)) {
+      return false;
+    }
+  }
+  Event event;
+  event.stamp_ns = now;
+  event.type = static_cast<uint16_t>(type);
+  event.reserved = 0;
+  event.ints[0] = a;
+  event.ints[1] = b;
+  event.ints[2] = c;
+  event.values[0] = x;
+  event.values[1] = y;
+  event.values[2] = z;
+  std::strncpy(event.text, text ? text : "", sizeof(event.text) - 1);
+  event.text[sizeof(event.text) - 1] = '\0';
+  if (!push(event)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+bool EventLog::push(const Event & event) {
+  // Bounded multi-producer queue: each cell's sequence says whose turn it is.
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  Cell * cell;
+  for (;;) {
+    cell = &cells_[pos & mask_];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;  // Full.
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  cell->event = event;
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool EventLog::pop(Event & event) {
+  Cell & cell = cells_[dequeue_pos_ & mask_];
+  if (cell.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+    return false;  // Empty, or the producer has not finished writing.
+  }
+  event = cell.event;
+  cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+  ++dequeue_pos_;
+  return true;
+}
+
+void EventLog::run() {
+  while (running_.load()) {
+    drain();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  drain();
+  file_.flush();
+}
+
+void EventLog::drain() {
+  Event event;
+  std::ostringstream text;
+  while (pop(event)) {
+    if (file_.is_open()) {
+      file_.write(reinterpret_cast<const char *>(&event), sizeof(event));
+    }
+    if (console_) {
+      text.str("");
+      format(event, text, state_names_.load());
+      ROS_INFO_STREAM(text.str());
+    }
+  }
+  const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+  if (dropped != reported_dropped_) {
+    ROS_WARN_STREAM("Event log full, dropped " << dropped - reported_dropped_ << " events");
+    reported_dropped_ = dropped;
+  }
+}
+
+void EventLog::format(const Event & event, std::ostream & out, StateNames state_names) {
+  switch (event.type) {
+    case kScore:
+      out << "Score: " << event.values[0];
+      break;
+    case kCompetitionState:
+      if (std::strcmp(event.text, "done") == 0) {
+        out << "Competition ended.";
+      } else {
+        out << "Competition state: " << event.text;
+      }
+      break;
+    case kOrder:
+      out << "Received order " << event.text << " with " << event.ints[0] << " kits, queued "
+          << event.ints[1] << " tasks, " << event.values[0] << " s of arm travel ("
+          << event.values[1] << " s in listed order)";
+      break;
+    case kJointState:
+      out << "Joint states: " << event.ints[0] << " joints (throttled)";
+      break;
+    case kTrayCamera:
+      out << "Logical camera_2: " << event.ints[0] << " objects, " << event.ints[1] << " parts";
+      break;
+    case kBreakBeam:
+      out << "Break beam triggered.";
+      break;
+    case kProximity:
+      out << "Proximity sensor sees something.";
+      break;
+    case kLaserProfiler:
+      out << "Conveyor: " << event.ints[0] << " parts tracked, belt at " << event.values[0] << " m/s.";
+      break;
+    case kTaskStarted:
+      out << "Next task: " << event.text << " from bin " << event.ints[0] << " to agv "
+          << event.ints[1] << " slot " << event.ints[2];
+      break;
+    case kTargetPart:
+      if (event.ints[1]) {
+        out << "Picking " << event.text << " at x = " << event.values[0] << ", y = " << event.values[1];
+      } else {
+        out << "No " << event.text << " seen by the camera, using bin " << event.ints[0];
+      }
+      break;
+    case kArmCommand:
+      out << "Move to " << event.text << ": " << event.ints[0] << " points in "
+          << event.values[0] << " s";
+      break;
+    case kConveyorPick:
+      if (event.ints[1]) {
+        out << "Meeting conveyor part " << event.ints[0] << " (" << event.text << ") in "
+            << event.values[0] << " s at y = " << event.values[1];
+      } else {
+        out << "Missed conveyor part " << event.ints[0] << " (" << event.text << ") at y = " << event.values[1];
+      }
+      break;
+    case kStateChange:
+      out << "State: ";
+      if (state_names) {
+        out << state_names(event.ints[0]);
+      } else {
+        out << event.ints[0];
+      }
+      out << " -> " << event.text << " after " << event.values[0] << " s";
+      if (event.ints[2]) {
+        out << " (timeout)";
+      }
+      break;
+    case kStartup:
+      out << "Startup: " << event.text;
+      break;
+    default:
+      out << "Unknown event " << event.type;
+      break;
+  }
+}
+
+void EventLog::write_header(std::ostream & out) {
+  const uint32_t record_size = sizeof(Event);
+  out.write(kMagic, sizeof(kMagic));
+  out.write(reinterpret_cast<const char *>(&kVersion), sizeof(kVersion));
+  out.write(reinterpret_cast<const char *>(&record_size), sizeof(record_size));
+}
+
+bool EventLog::read_header(std::istream & in) {
+  char magic[sizeof(kMagic)];
+  uint32_t version = 0, record_size = 0;
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char *>(&version), sizeof(version));
+  in.read(reinterpret_cast<char *>(&record_size), sizeof(record_size));
+  return in && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0 && version == kVersion &&
+    record_size == sizeof(Event);
+}
@@ -0,0 +1,43 @@
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "ariac_example/event_log.h"
+#include "ariac_example/task_state_machine.h"
+
+/*
+ * Offline decoder for the binary event log written by the node or the replay
+ * driver (~event_log_file / --events). Prints one line per event.
+ *
+ * Usage: ariac_example_events <events.log>
+ */
+int main(int argc, char ** argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <events.log>" << std::endl;
+    return 1;
+  }
+  std::ifstream in(argv[1], std::ios::binary);
+  if (!in) {
+    std::cerr << "Could not open " << argv[1] << std::endl;
+    return 1;
+  }
+  if (!EventLog::read_header(in)) {
+    std::cerr << argv[1] << " is not an event log of this version" << std::endl;
+    return 1;
+  }
+  Event event;
+  size_t events = 0;
+  while (in.read(reinterpret_cast<char *>(&event), sizeof(event))) {
+    std::cout << event.stamp_ns / 1000000000ull << "."
+              << std::setw(9) << std::setfill('0') << event.stamp_ns % 1000000000ull
+              << std::setfill(' ') << "  ";
+    EventLog::format(event, std::cout, &TaskStates::name_of);
+    std::cout << "\n";
+    ++events;
+  }
+  if (in.gcount() != 0) {
+    std::cerr << "Truncated record after " << events << " events" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,130 @@
+#include "ariac_example/gripper_actuator.h"
+
+#include <chrono>
+
+GripperActuator::GripperActuator(Transport & transport, bool use_worker, const ros::Duration & timeout)
+: transport_(transport), timeout_(timeout.toSec()), desired_(false), call_pending_(false),
+  enabled_(false), attached_(false), running_(use_worker)
+{
+  if (use_worker) {
+    worker_ = std::thread(&GripperActuator::run, this);
+  }
+}
+
+GripperActuator::~GripperActuator() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  changed_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+void GripperActuator::set_timeout(const ros::Duration & timeout) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  timeout_ = timeout.toSec();
+}
+
+bool GripperActuator::call(bool enable) {
+  osrf_gear::VacuumGripperControl srv;
+  srv.request.enable = enable;
+  return transport_.call_gripper(srv) && srv.response.success;
+}
+
+void GripperActuator::request(bool enable) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (enable == desired_) {
+    return;  // Already asked for (or already there).
+  }
+  desired_ = enable;
+  call_pending_ = enabled_ != enable;
+  if (!call_pending_) {
+    return;
+  }
+  if (worker_.joinable()) {
+    changed_.notify_all();
+    return;
+  }
+  // No worker: call inline, the gripper state will confirm it.
+  call_inline(lock);
+}
+
+void GripperActuator::update(const ros::Time & now) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (worker_.joinable() || !call_pending_ || now < retry_at_) {
+    return;
+  }
+  call_inline(lock);
+}
+
+void GripperActuator::call_inline(std::unique_lock<std::mutex> & lock) {
+  const bool enable = desired_;
+  call_pending_ = false;
+  lock.unlock();
+  const bool called = call(enable);
+  lock.lock();
+  if (!called && desired_ == enable) {
+    // Keep the request pending rather than drop it: a repeated request() is a no-op.
+    ROS_WARN_STREAM("Gripper " << (enable ? "enable" : "disable") << " request failed, retrying.");
+    call_pending_ = enabled_ != enable;
+    retry_at_ = ros::Time::now() + ros::Duration(timeout_);
+  }
+}
+
+void GripperActuator::on_state(const osrf_gear::VacuumGripperState & state) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  attached_ = state.attached;
+  if (enabled_ != state.enabled) {
+    enabled_ = state.enabled;
+    changed_.notify_all();
+  }
+}
+
+bool GripperActuator::confirmed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !call_pending_ && enabled_ == desired_;
+}
+
+bool GripperActuator::attached() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return attached_;
+}
+
+void GripperActuator::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_) {
+    changed_.wait(lock, [this]() { return !running_ || call_pending_; });
+    if (!running_) {
+      break;
+    }
+    const bool enable = desired_;
+    call_pending_ = false;
+
+    // Make the service call without holding the lock.
+    lock.unlock();
+    const bool called = call(enable);
+    lock.lock();
+
+    const std::chrono::duration<double> timeout(timeout_);
+    if (!called) {
+      ROS_WARN_STREAM("Gripper " << (enable ? "enable" : "disable") << " request failed, retrying.");
+      // Back off before calling again.
+      changed_.wait_for(lock, timeout, [this]() { return !running_; });
+    } else {
+      // Wait for the gripper state to confirm the call, or for a newer request.
+      const bool done = changed_.wait_for(lock, timeout, [this, enable]() {
+        return !running_ || call_pending_ || enabled_ == enable;
+      });
+      if (!done) {
+        ROS_WARN_STREAM("Gripper state did not confirm " << (enable ? "enable" : "disable")
+          << " within " << timeout_ << " s.");
+      }
+    }
+    // Keep calling until the reported state matches the latest request.
+    if (enabled_ != desired_) {
+      call_pending_ = true;
+    }
+  }
+}
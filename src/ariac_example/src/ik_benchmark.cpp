@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include "ariac_example/ik_table.h"
+#include "ariac_example/instrumentation.h"
+#include "ariac_example/waypoint_table.h"
+
+/*
+ * Benchmark for the IK lookup table: how long it takes to build, and how
+ * fast and how accurately it solves random gripper positions in its regions.
+ * Solving straight from the ready position is measured alongside, for
+ * comparison.
+ *
+ * Usage: ariac_example_ik_benchmark [samples] [resolution]
+ */
+
+namespace {
+
+struct Result {
+  LatencyHistogram time;
+  size_t solved = 0;
+  double max_position_error = 0.0;
+  double max_tilt = 0.0;
+};
+
+void report(const char * name, const Result & result, size_t samples) {
+  const LatencyHistogram::Snapshot s = result.time.snapshot();
+  std::cout << name << ": " << result.solved << "/" << samples << " solved, "
+            << "mean " << s.mean_ms() * 1e3 << " us, p99 " << s.percentile_ms(0.99) * 1e3
+            << " us, max error " << result.max_position_error * 1e3 << " mm / "
+            << result.max_tilt << " rad" << std::endl;
+}
+
+template <class Solver>
+void run(const ArmKinematics & kinematics, const std::vector<Vec3> & targets, Solver solver,
+         Result & result) {
+  for (size_t i = 0; i < targets.size(); ++i) {
+    JointPositions q;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const bool ok = solver(targets[i], q);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.time.record(elapsed.count());
+    if (!ok) {
+      continue;
+    }
+    ++result.solved;
+    ToolPose pose;
+    kinematics.forward(q, pose);
+    double error = 0.0;
+    for (int k = 0; k < 3; ++k) {
+      error += (pose.position[k] - targets[i][k]) * (pose.position[k] - targets[i][k]);
+    }
+    result.max_position_error = std::max(result.max_position_error, std::sqrt(error));
+    result.max_tilt = std::max(result.max_tilt, std::acos(std::min(1.0, -pose.axis[2])));
+  }
+}
+
+}  // namespace
+
+int main(int argc, char ** argv) {
+  const size_t samples = argc > 1 ? std::atoi(argv[1]) : 10000;
+  const double resolution = argc > 2 ? std::atof(argv[2]) : 0.05;
+  if (samples == 0 || resolution <= 0.0) {
+    std::cerr << "Usage: " << argv[0] << " [samples] [resolution]" << std::endl;
+    return 1;
+  }
+
+  WaypointTable waypoints;
+  ArmKinematics kinematics;
+  IkTable table(kinematics, resolution);
+  const Vec3 half_extent = {{0.3, 0.3, 0.15}};
+  const std::vector<int> bins = {6, 7};
+  const std::vector<int> agvs = {1, 2};
+
+  const std::chrono::steady_clock::time_point build_start = std::chrono::steady_clock::now();
+  table.add_regions(waypoints, bins, agvs, half_extent);
+  const std::chrono::duration<double> build_time = std::chrono::steady_clock::now() - build_start;
+  std::cout << "table: " << table.valid() << "/" << table.size() << " cells in "
+            << build_time.count() * 1e3 << " ms" << std::endl;
+
+  // Random targets inside the regions, around each hand-tuned seed.
+  std::vector<JointPositions> seeds;
+  for (size_t i = 0; i < bins.size(); ++i) {
+    PickWaypoints pick;
+    if (waypoints.pick(bins[i], 0, pick)) {
+      seeds.push_back(pick.grasp);
+    }
+  }
+  for (size_t i = 0; i < agvs.size(); ++i) {
+    JointPositions place;
+    if (waypoints.place(agvs[i], 0, place)) {
+      seeds.push_back(place);
+    }
+  }
+  std::mt19937 random(42);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  std::vector<Vec3> targets(samples);
+  for (size_t i = 0; i < samples; ++i) {
+    ToolPose pose;
+    kinematics.forward(seeds[i % seeds.size()], pose);
+    for (int k = 0; k < 3; ++k) {
+      targets[i][k] = pose.position[k] + half_extent[k] * unit(random);
+    }
+  }
+
+  Result seeded;
+  run(kinematics, targets, [&table](const Vec3 & target, JointPositions & q) {
+    return table.solve(target, q);
+  }, seeded);
+  report("table seed", seeded, samples);
+
+  Result cold;
+  run(kinematics, targets, [&kinematics, &waypoints](const Vec3 & target, JointPositions & q) {
+    q = waypoints.ready();
+    return kinematics.refine(target, q, IkTable::kBuildIterations, IkTable::kTolerance);
+  }, cold);
+  report("ready seed", cold, samples);
+  return 0;
+}
@@ -0,0 +1,139 @@
+#include "ariac_example/ik_table.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <ros/ros.h>
+
+constexpr double IkTable::kTolerance;
+
+IkTable::IkTable(const ArmKinematics & kinematics, double resolution)
+: kinematics_(kinematics), resolution_(resolution)
+{
+}
+
+size_t IkTable::add_region(const std::string & name, const Vec3 & min, const Vec3 & max,
+                           const JointPositions & seed) {
+  Region region;
+  region.name = name;
+  region.min = min;
+  region.max = max;
+  for (int k = 0; k < 3; ++k) {
+    region.cells[k] = static_cast<size_t>(std::floor((max[k] - min[k]) / resolution_ + 1e-9)) + 1;
+  }
+  region.offset = solutions_.size();
+  const size_t count = region.cells[0] * region.cells[1] * region.cells[2];
+  solutions_.resize(region.offset + count, seed);
+  converged_.resize(region.offset + count, 0);
+
+  // Walk the grid boustrophedon so each cell is next to the one solved before it.
+  JointPositions previous = seed;
+  size_t solved = 0;
+  for (size_t i = 0; i < region.cells[0]; ++i) {
+    for (size_t jj = 0; jj < region.cells[1]; ++jj) {
+      const size_t j = (i % 2 == 0) ? jj : region.cells[1] - 1 - jj;
+      for (size_t kk = 0; kk < region.cells[2]; ++kk) {
+        const size_t k = ((i * region.cells[1] + jj) % 2 == 0) ? kk : region.cells[2] - 1 - kk;
+        const Vec3 target = {{min[0] + i * resolution_, min[1] + j * resolution_, min[2] + k * resolution_}};
+        const size_t index = region.offset + (i * region.cells[1] + j) * region.cells[2] + k;
+        JointPositions q = previous;
+        bool ok = kinematics_.refine(target, q, kBuildIterations, kTolerance);
+        if (!ok) {
+          // Lost the branch; start over from the hand-tuned configuration.
+          q = seed;
+          ok = kinematics_.refine(target, q, kBuildIterations, kTolerance);
+        }
+        if (ok) {
+          solutions_[index] = q;
+          converged_[index] = 1;
+          previous = q;
+          ++solved;
+        }
+      }
+    }
+  }
+  regions_.push_back(region);
+  ROS_INFO_STREAM("IK region " << name << ": " << solved << " of " << count << " cells solved");
+  return solved;
+}
+
+size_t IkTable::add_region_around(const std::string & name, const JointPositions & seed,
+                                  const Vec3 & half_extent) {
+  ToolPose pose;
+  kinematics_.forward(seed, pose);
+  Vec3 min, max;
+  for (int k = 0; k < 3; ++k) {
+    min[k] = pose.position[k] - half_extent[k];
+    max[k] = pose.position[k] + half_extent[k];
+  }
+  return add_region(name, min, max, seed);
+}
+
+size_t IkTable::add_regions(const WaypointTable & table, const std::vector<int> & bins,
+                            const std::vector<int> & agvs, const Vec3 & half_extent) {
+  size_t solved = 0;
+  for (size_t i = 0; i < bins.size(); ++i) {
+    PickWaypoints pick;
+    if (table.pick(bins[i], 0, pick)) {
+      std::ostringstream name;
+      name << "bin" << bins[i];
+      solved += add_region_around(name.str(), pick.grasp, half_extent);
+    }
+  }
+  for (size_t i = 0; i < agvs.size(); ++i) {
+    JointPositions place;
+    if (table.place(agvs[i], 0, place)) {
+      std::ostringstream name;
+      name << "agv" << agvs[i];
+      solved += add_region_around(name.str(), place, half_extent);
+    }
+  }
+  return solved;
+}
+
+const IkTable::Region * IkTable::nearest_region(const Vec3 & target) const {
+  const Region * nearest = NULL;
+  double nearest_distance = 0.0;
+  for (size_t r = 0; r < regions_.size(); ++r) {
+    // Squared distance from the target to the box; zero inside it.
+    double distance = 0.0;
+    for (int k = 0; k < 3; ++k) {
+      const double outside = std::max(0.0, std::max(regions_[r].min[k] - target[k], target[k] - regions_[r].max[k]));
+      distance += outside * outside;
+    }
+    if (!nearest || distance < nearest_distance) {
+      nearest = &regions_[r];
+      nearest_distance = distance;
+    }
+  }
+  return nearest;
+}
+
+size_t IkTable::cell_index(const Region & region, const Vec3 & target) const {
+  size_t cell[3];
+  for (int k = 0; k < 3; ++k) {
+    const double position = std::floor((target[k] - region.min[k]) / resolution_ + 0.5);
+    cell[k] = static_cast<size_t>(std::min(std::max(position, 0.0), double(region.cells[k] - 1)));
+  }
+  return region.offset + (cell[0] * region.cells[1] + cell[1]) * region.cells[2] + cell[2];
+}
+
+bool IkTable::seed(const Vec3 & target, JointPositions & q) const {
+  const Region * region = nearest_region(target);
+  if (!region) {
+    return false;
+  }
+  q = solutions_[cell_index(*region, target)];
+  return true;
+}
+
+bool IkTable::solve(const Vec3 & target, JointPositions & q, double * error) const {
+  if (!seed(target, q)) {
+    return false;
+  }
+  return kinematics_.refine(target, q, kRefineIterations, kTolerance, error);
+}
+
+size_t IkTable::valid() const {
+  return std::count(converged_.begin(), converged_.end(), 1);
+}
@@ -0,0 +1,200 @@
+#include "ariac_example/instrumentation.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+size_t bucket_of(uint64_t us) {
+  if (us == 0) {
+    return 0;
+  }
+  const size_t bucket = 64 - __builtin_clzll(us);
+  return bucket < LatencyHistogram::kBuckets ? bucket : LatencyHistogram::kBuckets - 1;
+}
+
+std::string format_ms(double ms) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3) << ms;
+  return out.str();
+}
+
+diagnostic_msgs::KeyValue key_value(const std::string & key, const std::string & value) {
+  diagnostic_msgs::KeyValue kv;
+  kv.key = key;
+  kv.value = value;
+  return kv;
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram()
+: count_(0), total_us_(0), max_us_(0)
+{
+  for (size_t i = 0; i < kBuckets; ++i) {
+    buckets_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::record(double seconds) {
+  const uint64_t us = seconds > 0.0 ? static_cast<uint64_t>(seconds * 1e6) : 0;
+  buckets_[bucket_of(us)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_us_.fetch_add(us, std::memory_order_relaxed);
+  uint64_t max = max_us_.load(std::memory_order_relaxed);
+  while (us > max && !max_us_.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+  }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+  Snapshot snapshot;
+  snapshot.count = count_.load(std::memory_order_relaxed);
+  snapshot.total_us = total_us_.load(std::memory_order_relaxed);
+  snapshot.max_us = max_us_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < kBuckets; ++i) {
+    snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+void LatencyHistogram::Snapshot::merge(const Snapshot & other) {
+  count += other.count;
+  total_us += other.total_us;
+  max_us = std::max(max_us, other.max_us);
+  for (size_t i = 0; i < kBuckets; ++i) {
+    buckets[i] += other.buckets[i];
+  }
+}
+
+double LatencyHistogram::Snapshot::mean_ms() const {
+  return count > 0 ? total_us / 1e3 / count : 0.0;
+}
+
+double LatencyHistogram::Snapshot::percentile_ms(double p) const {
+  uint64_t total = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    total += buckets[i];
+  }
+  if (total == 0) {
+    return 0.0;
+  }
+  const double rank = p * total;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += buckets[i];
+    if (seen >= rank && buckets[i] > 0) {
+      // Bucket i ends at 2^i us; never report more than the largest value seen.
+      const double upper_us = static_cast<double>(uint64_t(1) << i);
+      return std::min(upper_us, static_cast<double>(max_us)) / 1e3;
+    }
+  }
+  return max_us / 1e3;
+}
+
+const char * Instrumentation::name(Probe probe) {
+  switch (probe) {
+    case kCurrentScoreCallback: return "current_score_callback";
+    case kCompetitionStateCallback: return "competition_state_callback";
+    case kOrderCallback: return "order_callback";
+    case kJointStateCallback: return "joint_state_callback";
+    case kLogicalCameraCallback: return "logical_camera_callback";
+    case kTrayLogicalCameraCallback: return "tray_logical_camera_callback";
+    case kBreakBeamCallback: return "break_beam_callback";
+    case kProximitySensorCallback: return "proximity_sensor_callback";
+    case kLaserProfilerCallback: return "laser_profiler_callback";
+    case kGripperStateCallback: return "gripper_state_callback";
+    case kControlTick: return "control_tick";
+    case kJointStateAge: return "joint_state_age";
+    case kSensorAge: return "sensor_age";
+    case kArmCommandPublish: return "arm_command_publish";
+    case kCommandToMotion: return "command_to_motion";
+    case kTfLookup: return "tf_lookup";
+    case kGripperCall: return "gripper_call";
+    case kCollisionCheck: return "collision_check";
+    case kAgvCall: return "agv_call";
+    case kWarmUp: return "warm_up";
+    case kTimeToFirstCommand: return "time_to_first_command";
+    default: return "unknown";
+  }
+}
+
+size_t Instrumentation::thread_slot() {
+  static std::atomic<size_t> next_slot(0);
+  static thread_local const size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) % kThreadSlots;
+  return slot;
+}
+
+LatencyHistogram::Snapshot Instrumentation::snapshot(Probe probe) const {
+  LatencyHistogram::Snapshot merged = slots_[0].histograms[probe].snapshot();
+  for (size_t i = 1; i < kThreadSlots; ++i) {
+    merged.merge(slots_[i].histograms[probe].snapshot());
+  }
+  return merged;
+}
+
+void Instrumentation::record_age(Probe probe, const ros::Time & stamp) {
+  if (stamp.isZero()) {
+    return;
+  }
+  record(probe, (ros::Time::now() - stamp).toSec());
+}
+
+void Instrumentation::fill(diagnostic_msgs::DiagnosticArray & diagnostics) const {
+  diagnostics.status.clear();
+  for (int i = 0; i < kNumProbes; ++i) {
+    const LatencyHistogram::Snapshot s = snapshot(static_cast<Probe>(i));
+    if (s.count == 0) {
+      continue;
+    }
+    diagnostic_msgs::DiagnosticStatus status;
+    status.level = diagnostic_msgs::DiagnosticStatus::OK;
+    status.name = std::string("ariac_example: ") + name(static_cast<Probe>(i));
+    status.hardware_id = "ariac_example";
+    std::ostringstream count;
+    count << s.count;
+    status.values.push_back(key_value("count", count.str()));
+    status.values.push_back(key_value("mean_ms", format_ms(s.mean_ms())));
+    status.values.push_back(key_value("p50_ms", format_ms(s.percentile_ms(0.5))));
+    status.values.push_back(key_value("p99_ms", format_ms(s.percentile_ms(0.99))));
+    status.values.push_back(key_value("max_ms", format_ms(s.max_us / 1e3)));
+    diagnostics.status.push_back(status);
+  }
+}
+
+void Instrumentation::write(std::ostream & out) const {
+  out << std::left << std::setw(30) << "probe" << std::right
+      << std::setw(10) << "count" << std::setw(12) << "mean_ms" << std::setw(12) << "p50_ms"
+      << std::setw(12) << "p99_ms" << std::setw(12) << "max_ms" << "\n";
+  for (int i = 0; i < kNumProbes; ++i) {
+    const LatencyHistogram::Snapshot s = snapshot(static_cast<Probe>(i));
+    if (s.count == 0) {
+      continue;
+    }
+    out << std::left << std::setw(30) << name(static_cast<Probe>(i)) << std::right
+        << std::setw(10) << s.count
+        << std::setw(12) << format_ms(s.mean_ms())
+        << std::setw(12) << format_ms(s.percentile_ms(0.5))
+        << std::setw(12) << format_ms(s.percentile_ms(0.99))
+        << std::setw(12) << format_ms(s.max_us / 1e3) << "\n";
+  }
+}
+
+void InstrumentedTransport::publish_arm_command(const trajectory_msgs::JointTrajectory & traj) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kArmCommandPublish);
+  transport_.publish_arm_command(traj);
+}
+
+bool InstrumentedTransport::call_gripper(osrf_gear::VacuumGripperControl & srv) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kGripperCall);
+  return transport_.call_gripper(srv);
+}
+
+bool InstrumentedTransport::call_agv(int agv, osrf_gear::AGVControl & srv) {
+  ScopedTimer timer(instrumentation_, Instrumentation::kAgvCall);
+  return transport_.call_agv(agv, srv);
+}
+
+void InstrumentedTransport::publish_diagnostics(const diagnostic_msgs::DiagnosticArray & diagnostics) {
+  transport_.publish_diagnostics(diagnostics);
+}
@@ -0,0 +1,69 @@
+#include "ariac_example/joint_index.h"
+
+#include <ros/ros.h>
+
+const std::vector<std::string> & arm_joint_names() {
+  static const std::vector<std::string> names = {
+    "elbow_joint",
+    "linear_arm_actuator_joint",
+    "shoulder_lift_joint",
+    "shoulder_pan_joint",
+    "wrist_1_joint",
+    "wrist_2_joint",
+    "wrist_3_joint",
+  };
+  return names;
+}
+
+JointIndex::JointIndex()
+: message_size_(0), resolved_(false)
+{
+  slot_.fill(0);
+}
+
+bool JointIndex::matches(const std::vector<std::string> & names) const {
+  if (!resolved_ || names.size() != message_size_) {
+    return false;
+  }
+  const std::vector<std::string> & arm_names = arm_joint_names();
+  for (size_t i = 0; i < kNumArmJoints; ++i) {
+    if (names[slot_[i]] != arm_names[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool JointIndex::resolve(const std::vector<std::string> & names) {
+  resolved_ = false;
+  const std::vector<std::string> & arm_names = arm_joint_names();
+  for (size_t i = 0; i < kNumArmJoints; ++i) {
+    size_t j = 0;
+    while (j < names.size() && names[j] != arm_names[i]) {
+      ++j;
+    }
+    if (j == names.size()) {
+      ROS_WARN_STREAM_THROTTLE(1, "Joint state has no '" << arm_names[i] << "'");
+      return false;
+    }
+    slot_[i] = j;
+  }
+  message_size_ = names.size();
+  resolved_ = true;
+  ROS_INFO("Resolved arm joint order from the joint state names.");
+  return true;
+}
+
+bool JointIndex::gather(const sensor_msgs::JointState & msg, const std::vector<double> & values,
+                        JointPositions & out) {
+  if (!matches(msg.name) && !resolve(msg.name)) {
+    return false;
+  }
+  if (values.size() < message_size_) {
+    return false;
+  }
+  for (size_t i = 0; i < kNumArmJoints; ++i) {
+    out[i] = values[slot_[i]];
+  }
+  return true;
+}
@@ -0,0 +1,114 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "ariac_example/task_engine.h"
+#include "ariac_example/trajectory_timing.h"
+#include "ariac_example/tray_manager.h"
+#include "ariac_example/waypoint_table.h"
+
+/*
+ * Benchmark for kit building on one AGV against both AGVs in turn: orders
+ * per minute when a tray is away for a fixed transit time after it is
+ * submitted. The arm's time per part is its travel time through the
+ * hand-tuned waypoints plus a fixed allowance for the gripper.
+ *
+ * Usage: ariac_example_kit_benchmark [orders] [parts per kit] [transit time (s)]
+ */
+
+namespace {
+
+/// Accepts every AGV call; nothing else is used.
+class StubTransport : public Transport
+{
+public:
+  void publish_arm_command(const trajectory_msgs::JointTrajectory &) {}
+  bool call_gripper(osrf_gear::VacuumGripperControl &) { return true; }
+  bool call_agv(int, osrf_gear::AGVControl & srv) {
+    srv.response.success = true;
+    return true;
+  }
+  void publish_diagnostics(const diagnostic_msgs::DiagnosticArray &) {}
+};
+
+// Seconds per part for the gripper to grip and release, on top of arm travel.
+const double kGripperTime = 1.0;
+// Simulation step while waiting for a tray.
+const double kStep = 0.1;
+
+/// Simulated seconds to build every kit, and the orders per minute the trays report.
+double run(const std::vector<int> & agvs, const std::vector<osrf_gear::Order> & orders, double transit,
+           double & orders_per_minute) {
+  WaypointTable table;
+  TaskEngine engine(table);
+  engine.set_part_bin("gear_part", 6);
+  engine.set_part_bin("piston_rod_part", 7);
+  engine.set_agvs(agvs);
+  for (size_t i = 0; i < orders.size(); ++i) {
+    engine.add_order(orders[i]);
+  }
+
+  StubTransport transport;
+  TrayManager trays(transport, false, ros::Duration(transit));
+  TrajectoryTiming timing;
+  JointPositions arm = table.ready();
+  ros::Time now(1.0);
+  size_t kits = 0;
+  for (size_t i = 0; i < orders.size(); ++i) {
+    kits += orders[i].kits.size();
+  }
+  PickPlaceTask task;
+  while (trays.kits_submitted() < kits) {
+    trays.update(now);
+    if (!engine.front(task) || !trays.available(task.agv, task.kit)) {
+      now = now + ros::Duration(kStep);
+      continue;
+    }
+    trays.start_kit(task, now);
+    const double travel = timing.segment_time(arm, task.pick.approach) +
+      2.0 * timing.segment_time(task.pick.approach, task.pick.grasp) +
+      timing.segment_time(task.pick.approach, task.place_goal);
+    now = now + ros::Duration(travel + kGripperTime);
+    arm = task.place_goal;
+    trays.placed(task.agv, now);
+    engine.pop();
+  }
+  orders_per_minute = trays.orders_per_minute();
+  return now.toSec() - 1.0;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv) {
+  const int orders = argc > 1 ? std::atoi(argv[1]) : 10;
+  const int parts = argc > 2 ? std::atoi(argv[2]) : 4;
+  const double transit = argc > 3 ? std::atof(argv[3]) : 20.0;
+  if (orders <= 0 || parts <= 0 || transit < 0.0) {
+    std::cerr << "Usage: " << argv[0] << " [orders] [parts per kit] [transit time (s)]" << std::endl;
+    return 1;
+  }
+
+  // Two kits per order, alternating gears and piston rods.
+  std::vector<osrf_gear::Order> queue(orders);
+  for (int o = 0; o < orders; ++o) {
+    queue[o].order_id = "order_" + std::to_string(o);
+    queue[o].kits.resize(2);
+    for (size_t k = 0; k < queue[o].kits.size(); ++k) {
+      queue[o].kits[k].kit_type = queue[o].order_id + "_kit_" + std::to_string(k);
+      queue[o].kits[k].objects.resize(parts);
+      for (int p = 0; p < parts; ++p) {
+        queue[o].kits[k].objects[p].type = p % 2 ? "piston_rod_part" : "gear_part";
+      }
+    }
+  }
+
+  std::cout << std::setw(8) << "agvs" << std::setw(12) << "total_s" << std::setw(16) << "orders/min" << "\n";
+  const std::vector<int> configs[] = {{1}, {1, 2}};
+  for (size_t c = 0; c < 2; ++c) {
+    double rate = 0.0;
+    const double total = run(configs[c], queue, transit, rate);
+    std::cout << std::fixed << std::setprecision(2) << std::setw(8) << configs[c].size()
+              << std::setw(12) << total << std::setw(16) << rate << "\n";
+  }
+  return 0;
+}
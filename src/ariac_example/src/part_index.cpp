@@ -0,0 +1,132 @@
+#include "ariac_example/part_index.h"
+
+#include <cmath>
+#include <tf/transform_datatypes.h>
+
+namespace {
+
+double distance(const geometry_msgs::Point & a, const geometry_msgs::Point & b) {
+  const double dx = a.x - b.x;
+  const double dy = a.y - b.y;
+  const double dz = a.z - b.z;
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+}  // namespace
+
+PartIndex::PartIndex(double match_distance)
+: match_distance_(match_distance)
+{
+}
+
+bool PartIndex::is_part(const std::string & type) {
+  static const std::string suffix = "_part";
+  return type.size() > suffix.size() &&
+    type.compare(type.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void PartIndex::update(int camera, const osrf_gear::LogicalCameraImage & image) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const unsigned int frame = ++frames_[camera];
+
+  tf::Transform camera_pose;
+  tf::poseMsgToTF(image.pose, camera_pose);
+
+  for (size_t i = 0; i < image.models.size(); ++i) {
+    const osrf_gear::Model & model = image.models[i];
+    if (!is_part(model.type)) {
+      continue;
+    }
+    // Model poses are relative to the camera.
+    tf::Transform model_pose;
+    tf::poseMsgToTF(model.pose, model_pose);
+    geometry_msgs::Pose world_pose;
+    tf::poseTFToMsg(camera_pose * model_pose, world_pose);
+
+    Row & row = parts_[model.type];
+    const double y = world_pose.position.y;
+    Row::iterator match = row.end();
+    for (Row::iterator it = row.lower_bound(y - match_distance_);
+         it != row.end() && it->first <= y + match_distance_; ++it) {
+      if (it->second.camera == camera && it->second.frame != frame &&
+          distance(it->second.pose.position, world_pose.position) < match_distance_) {
+        match = it;
+        break;
+      }
+    }
+    if (match == row.end()) {
+      IndexedPart part;
+      part.type = model.type;
+      part.camera = camera;
+      part.pose = world_pose;
+      part.frame = frame;
+      row.insert(std::make_pair(y, part));
+    } else if (match->first == y) {
+      match->second.pose = world_pose;
+      match->second.frame = frame;
+    } else {
+      // Moved along the rail axis: re-key it.
+      IndexedPart part = match->second;
+      part.pose = world_pose;
+      part.frame = frame;
+      row.erase(match);
+      row.insert(std::make_pair(y, part));
+    }
+  }
+
+  // Whatever this camera did not report again has been picked up or moved away.
+  for (std::map<std::string, Row>::iterator row = parts_.begin(); row != parts_.end(); ++row) {
+    for (Row::iterator it = row->second.begin(); it != row->second.end();) {
+      if (it->second.camera == camera && it->second.frame != frame) {
+        row->second.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+bool PartIndex::nearest(const std::string & type, const geometry_msgs::Point & point, double max_distance,
+                        int camera, IndexedPart & part) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::map<std::string, Row>::const_iterator row = parts_.find(type);
+  if (row == parts_.end() || row->second.empty()) {
+    return false;
+  }
+  double best = max_distance;
+  bool found = false;
+  const Row::const_iterator start = row->second.lower_bound(point.y);
+  // Walk outwards in y until the y gap alone exceeds the best distance found.
+  for (Row::const_iterator it = start; it != row->second.end() && it->first - point.y < best; ++it) {
+    const double d = distance(it->second.pose.position, point);
+    if ((camera < 0 || it->second.camera == camera) && d < best) {
+      best = d;
+      part = it->second;
+      found = true;
+    }
+  }
+  for (Row::const_iterator it = start; it != row->second.begin();) {
+    --it;
+    if (point.y - it->first >= best) {
+      break;
+    }
+    const double d = distance(it->second.pose.position, point);
+    if ((camera < 0 || it->second.camera == camera) && d < best) {
+      best = d;
+      part = it->second;
+      found = true;
+    }
+  }
+  return found;
+}
+
+size_t PartIndex::count(int camera) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t n = 0;
+  for (std::map<std::string, Row>::const_iterator row = parts_.begin(); row != parts_.end(); ++row) {
+    for (Row::const_iterator it = row->second.begin(); it != row->second.end(); ++it) {
+      n += it->second.camera == camera;
+    }
+  }
+  return n;
+}
@@ -0,0 +1,207 @@
+#include "ariac_example/pick_planner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/// Travel times between cycles, computed once per plan.
+struct CostMatrix {
+  size_t n;
+  std::vector<double> from_start;  ///< start to each approach
+  std::vector<double> between;     ///< n x n, place of i to approach of j
+  double fixed;                    ///< sum of the legs inside the cycles
+
+  double edge(size_t i, size_t j) const { return between[i * n + j]; }
+};
+
+void build_costs(const TrajectoryTiming & timing, const JointPositions & start,
+                 const std::vector<PickWaypoints> & picks, const std::vector<JointPositions> & places,
+                 CostMatrix & costs) {
+  const size_t n = picks.size();
+  costs.n = n;
+  costs.from_start.resize(n);
+  costs.between.resize(n * n);
+  costs.fixed = 0.0;
+  for (size_t j = 0; j < n; ++j) {
+    costs.from_start[j] = timing.segment_time(start, picks[j].approach);
+    costs.fixed += timing.segment_time(picks[j].approach, picks[j].grasp) +
+      timing.segment_time(picks[j].grasp, picks[j].approach) +
+      timing.segment_time(picks[j].approach, places[j]);
+    for (size_t i = 0; i < n; ++i) {
+      costs.between[i * n + j] = i == j ? 0.0 : timing.segment_time(places[i], picks[j].approach);
+    }
+  }
+}
+
+double path_cost(const CostMatrix & costs, const std::vector<size_t> & order) {
+  if (order.empty()) {
+    return 0.0;
+  }
+  double cost = costs.from_start[order[0]];
+  for (size_t k = 1; k < order.size(); ++k) {
+    cost += costs.edge(order[k - 1], order[k]);
+  }
+  return cost;
+}
+
+/// Held-Karp over subsets; false if the deadline passed first.
+bool exact(const CostMatrix & costs, const Clock::time_point & deadline, std::vector<size_t> & order) {
+  const size_t n = costs.n;
+  const size_t subsets = size_t(1) << n;
+  const double inf = std::numeric_limits<double>::infinity();
+  std::vector<double> best(subsets * n, inf);  ///< [mask][last]: cheapest path visiting mask, ending at last
+  std::vector<unsigned char> previous(subsets * n, 0);
+  for (size_t j = 0; j < n; ++j) {
+    best[(size_t(1) << j) * n + j] = costs.from_start[j];
+  }
+  for (size_t mask = 1; mask < subsets; ++mask) {
+    if ((mask & 0xff) == 0 && Clock::now() > deadline) {
+      return false;
+    }
+    for (size_t last = 0; last < n; ++last) {
+      const double cost = best[mask * n + last];
+      if (cost == inf) {
+        continue;
+      }
+      for (size_t next = 0; next < n; ++next) {
+        if (mask & (size_t(1) << next)) {
+          continue;
+        }
+        const size_t extended = mask | (size_t(1) << next);
+        const double candidate = cost + costs.edge(last, next);
+        if (candidate < best[extended * n + next]) {
+          best[extended * n + next] = candidate;
+          previous[extended * n + next] = static_cast<unsigned char>(last);
+        }
+      }
+    }
+  }
+  // Walk back from the cheapest full path.
+  size_t mask = subsets - 1;
+  size_t last = 0;
+  for (size_t j = 1; j < n; ++j) {
+    if (best[mask * n + j] < best[mask * n + last]) {
+      last = j;
+    }
+  }
+  order.resize(n);
+  for (size_t k = n; k-- > 0;) {
+    order[k] = last;
+    const size_t before = previous[mask * n + last];
+    mask &= ~(size_t(1) << last);
+    last = before;
+  }
+  return true;
+}
+
+/// Nearest neighbour from the start, then relocate moves until none helps or time is up.
+void heuristic(const CostMatrix & costs, const Clock::time_point & deadline, std::vector<size_t> & order) {
+  const size_t n = costs.n;
+  std::vector<bool> visited(n, false);
+  order.clear();
+  for (size_t k = 0; k < n; ++k) {
+    size_t best = n;
+    double best_cost = 0.0;
+    for (size_t j = 0; j < n; ++j) {
+      if (visited[j]) {
+        continue;
+      }
+      const double cost = order.empty() ? costs.from_start[j] : costs.edge(order.back(), j);
+      if (best == n || cost < best_cost) {
+        best = j;
+        best_cost = cost;
+      }
+    }
+    visited[best] = true;
+    order.push_back(best);
+  }
+
+  // Relocate: take one cycle out and put it back where it is cheapest. Costs are
+  // asymmetric, so only moves that keep the direction of every other edge are used.
+  bool improved = true;
+  while (improved && Clock::now() < deadline) {
+    improved = false;
+    for (size_t from = 0; from < n && !improved; ++from) {
+      const size_t node = order[from];
+      // Cost of the path without the node.
+      double removed;
+      if (from == 0) {
+        removed = -costs.from_start[node] + (n > 1 ? costs.from_start[order[1]] - costs.edge(node, order[1]) : 0.0);
+      } else {
+        removed = -costs.edge(order[from - 1], node);
+        if (from + 1 < n) {
+          removed += costs.edge(order[from - 1], order[from + 1]) - costs.edge(node, order[from + 1]);
+        }
+      }
+      std::vector<size_t> rest(order);
+      rest.erase(rest.begin() + from);
+      for (size_t to = 0; to <= rest.size(); ++to) {
+        if (to == from) {
+          continue;  // Back where it was.
+        }
+        double inserted;
+        if (to == 0) {
+          inserted = costs.from_start[node] + costs.edge(node, rest[0]) - costs.from_start[rest[0]];
+        } else if (to == rest.size()) {
+          inserted = costs.edge(rest[to - 1], node);
+        } else {
+          inserted = costs.edge(rest[to - 1], node) + costs.edge(node, rest[to]) - costs.edge(rest[to - 1], rest[to]);
+        }
+        if (removed + inserted < -1e-9) {
+          rest.insert(rest.begin() + to, node);
+          order.swap(rest);
+          improved = true;
+          break;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+PickPlanner::PickPlanner()
+: time_budget_(0.01), exact_limit_(10)
+{
+}
+
+void PickPlanner::set_timing(const TrajectoryTiming & timing) {
+  timing_ = timing;
+}
+
+void PickPlanner::set_time_budget(double seconds) {
+  time_budget_ = seconds;
+}
+
+void PickPlanner::set_exact_limit(size_t parts) {
+  // The back pointers are bytes, and 2^n subsets have to fit in memory.
+  exact_limit_ = std::min<size_t>(parts, 16);
+}
+
+double PickPlanner::cycle_time(const JointPositions & start, const std::vector<PickWaypoints> & picks,
+                               const std::vector<JointPositions> & places,
+                               const std::vector<size_t> & order) const {
+  CostMatrix costs;
+  build_costs(timing_, start, picks, places, costs);
+  return costs.fixed + path_cost(costs, order);
+}
+
+double PickPlanner::plan(const JointPositions & start, const std::vector<PickWaypoints> & picks,
+                         const std::vector<JointPositions> & places, std::vector<size_t> & order) const {
+  const Clock::time_point deadline = Clock::now() +
+    std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(time_budget_));
+  CostMatrix costs;
+  build_costs(timing_, start, picks, places, costs);
+  if (costs.n == 0) {
+    order.clear();
+    return 0.0;
+  }
+  if (costs.n > exact_limit_ || !exact(costs, deadline, order)) {
+    heuristic(costs, deadline, order);
+  }
+  return costs.fixed + path_cost(costs, order);
+}
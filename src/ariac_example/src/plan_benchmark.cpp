@@ -0,0 +1,121 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "ariac_example/ik_table.h"
+#include "ariac_example/pick_planner.h"
+#include "ariac_example/trajectory_timing.h"
+#include "ariac_example/waypoint_table.h"
+
+/*
+ * Benchmark for the pick planner: planned arm travel time per kit against
+ * doing the parts in the order they are listed, for random kits of several
+ * sizes. Parts are spread over bins 6 and 7 and the AGV 1 tray, with their
+ * joint configurations from the IK table, so the legs have realistic lengths.
+ *
+ * Usage: ariac_example_plan_benchmark [kits per size] [time budget (s)]
+ */
+
+namespace {
+
+/// A random gripper position within `spread` of where a configuration puts it.
+Vec3 near(const ArmKinematics & kinematics, const JointPositions & q, double spread, double height,
+          std::mt19937 & random) {
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  ToolPose pose;
+  kinematics.forward(q, pose);
+  Vec3 target = {{pose.position[0] + spread * unit(random), pose.position[1] + spread * unit(random),
+                  pose.position[2] + height}};
+  return target;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv) {
+  const int kits = argc > 1 ? std::atoi(argv[1]) : 100;
+  const double budget = argc > 2 ? std::atof(argv[2]) : 0.01;
+  if (kits <= 0 || budget <= 0.0) {
+    std::cerr << "Usage: " << argv[0] << " [kits per size] [time budget (s)]" << std::endl;
+    return 1;
+  }
+
+  WaypointTable waypoints;
+  ArmKinematics kinematics;
+  IkTable ik(kinematics);
+  const Vec3 half_extent = {{0.3, 0.3, 0.25}};
+  ik.add_regions(waypoints, {6, 7}, {1}, half_extent);
+
+  TrajectoryTiming timing;
+  timing.set_limits(timing.max_velocity(), timing.max_acceleration(), 0.5);
+  timing.set_min_segment_time(0.1);
+  PickPlanner planner;
+  planner.set_timing(timing);
+  planner.set_time_budget(budget);
+
+  std::vector<JointPositions> bin_seeds, tray_seeds;
+  PickWaypoints pick;
+  JointPositions place;
+  for (int bin = 6; bin <= 7; ++bin) {
+    if (waypoints.pick(bin, 0, pick)) {
+      bin_seeds.push_back(pick.grasp);
+    }
+  }
+  if (waypoints.place(1, 0, place)) {
+    tray_seeds.push_back(place);
+  }
+
+  std::mt19937 random(7);
+  std::cout << std::setw(6) << "parts" << std::setw(14) << "listed_s/kit" << std::setw(14) << "planned_s/kit"
+            << std::setw(10) << "saved_%" << std::setw(14) << "plan_mean_ms" << std::setw(13) << "plan_max_ms"
+            << "\n";
+  const size_t sizes[] = {3, 5, 8, 10, 12, 20, 40};
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+    const size_t parts = sizes[s];
+    double listed_total = 0.0, planned_total = 0.0, plan_total = 0.0, plan_max = 0.0;
+    int solved_kits = 0;
+    for (int kit = 0; kit < kits; ++kit) {
+      std::vector<PickWaypoints> picks;
+      std::vector<JointPositions> places;
+      for (size_t p = 0; p < parts && picks.size() < parts; ++p) {
+        const JointPositions & bin = bin_seeds[random() % bin_seeds.size()];
+        const Vec3 grasp = near(kinematics, bin, 0.25, 0.0, random);
+        const Vec3 approach = {{grasp[0], grasp[1], grasp[2] + 0.2}};
+        const Vec3 tray = near(kinematics, tray_seeds[0], 0.2, 0.05, random);
+        PickWaypoints part;
+        JointPositions goal;
+        if (ik.solve(approach, part.approach) && ik.solve(grasp, part.grasp) && ik.solve(tray, goal)) {
+          picks.push_back(part);
+          places.push_back(goal);
+        }
+      }
+      if (picks.empty()) {
+        continue;
+      }
+      std::vector<size_t> listed(picks.size());
+      for (size_t i = 0; i < listed.size(); ++i) {
+        listed[i] = i;
+      }
+      std::vector<size_t> order;
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      const double planned = planner.plan(waypoints.ready(), picks, places, order);
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      listed_total += planner.cycle_time(waypoints.ready(), picks, places, listed);
+      planned_total += planned;
+      plan_total += elapsed.count();
+      plan_max = std::max(plan_max, elapsed.count());
+      ++solved_kits;
+    }
+    if (solved_kits == 0) {
+      continue;
+    }
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(6) << parts << std::setw(14) << listed_total / solved_kits
+              << std::setw(14) << planned_total / solved_kits
+              << std::setw(10) << 100.0 * (listed_total - planned_total) / listed_total
+              << std::setprecision(3)
+              << std::setw(14) << 1e3 * plan_total / solved_kits << std::setw(13) << 1e3 * plan_max << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,257 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <ros/ros.h>
+#include <rosbag/bag.h>
+#include <rosbag/view.h>
+#include <tf/transform_datatypes.h>
+#include <tf2_msgs/TFMessage.h>
+
+#include "ariac_example/competition.h"
+#include "ariac_example/competition_config.h"
+#include "ariac_example/transport.h"
+
+/*
+ * Offline replay driver: feeds a recorded bag through MyCompetitionClass
+ * without Gazebo or a ROS master, as fast as the messages can be processed.
+ * The clock is driven from the bag timestamps and the control loop is ticked
+ * at the configured rate in that clock, so runs are repeatable.
+ *
+ * Usage: ariac_example_replay <input.bag> [--output <commands.bag>] [--control-rate <Hz>]
+ *                             [--events <events.log>]
+ */
+
+/// Stands in for the competition: records commands and accepts every gripper call.
+class ReplayTransport : public Transport
+{
+public:
+  explicit ReplayTransport(rosbag::Bag * output)
+  : output_(output), arm_commands_(0), gripper_calls_(0), agv_calls_(0)
+  {
+  }
+
+  void publish_arm_command(const trajectory_msgs::JointTrajectory & traj) {
+    ++arm_commands_;
+    if (output_) {
+      output_->write("/ariac/arm/command", ros::Time::now(), traj);
+    }
+  }
+
+  bool call_gripper(osrf_gear::VacuumGripperControl & srv) {
+    ++gripper_calls_;
+    if (output_) {
+      output_->write("/ariac/gripper/control", ros::Time::now(), srv.request);
+    }
+    srv.response.success = true;
+    return true;
+  }
+
+  bool call_agv(int agv, osrf_gear::AGVControl & srv) {
+    ++agv_calls_;
+    if (output_) {
+      output_->write("/ariac/agv" + std::to_string(agv), ros::Time::now(), srv.request);
+    }
+    srv.response.success = true;
+    return true;
+  }
+
+  void publish_diagnostics(const diagnostic_msgs::DiagnosticArray & diagnostics) {
+    if (output_) {
+      output_->write("/diagnostics", ros::Time::now(), diagnostics);
+    }
+  }
+
+  size_t arm_commands() const { return arm_commands_; }
+  size_t gripper_calls() const { return gripper_calls_; }
+  size_t agv_calls() const { return agv_calls_; }
+
+private:
+  rosbag::Bag * output_;
+  size_t arm_commands_;
+  size_t gripper_calls_;
+  size_t agv_calls_;
+};
+
+/// Instantiate a recorded message as M and hand it to a callback; false on a type mismatch.
+template <class M, class Callback>
+bool feed(const rosbag::MessageInstance & m, Callback callback) {
+  typename M::ConstPtr msg = m.instantiate<M>();
+  if (!msg) {
+    return false;
+  }
+  callback(msg);
+  return true;
+}
+
+/// Dispatch one recorded message to the callback the node subscribes it to.
+bool dispatch(const rosbag::MessageInstance & m, MyCompetitionClass & comp) {
+  const std::string & topic = m.getTopic();
+  if (topic == "/ariac/joint_states") {
+    return feed<sensor_msgs::JointState>(m, [&comp](const sensor_msgs::JointState::ConstPtr & msg) {
+      comp.joint_state_callback(msg);
+    });
+  } else if (topic == "/ariac/gripper/state") {
+    return feed<osrf_gear::VacuumGripperState>(m, [&comp](const osrf_gear::VacuumGripperState::ConstPtr & msg) {
+      comp.gripper_state_attatch_callback(msg);
+    });
+  } else if (topic == "/ariac/logical_camera_1") {
+    return feed<osrf_gear::LogicalCameraImage>(m, [&comp](const osrf_gear::LogicalCameraImage::ConstPtr & msg) {
+      comp.logical_camera_callback(msg);
+    });
+  } else if (topic == "/ariac/logical_camera_2") {
+    return feed<osrf_gear::LogicalCameraImage>(m, [&comp](const osrf_gear::LogicalCameraImage::ConstPtr & msg) {
+      comp.tray_logical_camera_callback(msg);
+    });
+  } else if (topic == "/ariac/orders") {
+    return feed<osrf_gear::Order>(m, [&comp](const osrf_gear::Order::ConstPtr & msg) {
+      comp.order_callback(msg);
+    });
+  } else if (topic == "/ariac/current_score") {
+    return feed<std_msgs::Float32>(m, [&comp](const std_msgs::Float32::ConstPtr & msg) {
+      comp.current_score_callback(msg);
+    });
+  } else if (topic == "/ariac/competition_state") {
+    return feed<std_msgs::String>(m, [&comp](const std_msgs::String::ConstPtr & msg) {
+      comp.competition_state_callback(msg);
+    });
+  } else if (topic == "/ariac/break_beam_1_change") {
+    return feed<osrf_gear::Proximity>(m, [&comp](const osrf_gear::Proximity::ConstPtr & msg) {
+      comp.break_beam_callback(msg);
+    });
+  } else if (topic == "/ariac/proximity_sensor_1") {
+    return feed<sensor_msgs::Range>(m, [&comp](const sensor_msgs::Range::ConstPtr & msg) {
+      comp.proximity_sensor_callback(msg);
+    });
+  } else if (topic == "/ariac/laser_profiler_1") {
+    return feed<sensor_msgs::LaserScan>(m, [&comp](const sensor_msgs::LaserScan::ConstPtr & msg) {
+      comp.laser_profiler_callback(msg);
+    });
+  } else if (topic == "/tf" || topic == "/tf_static") {
+    const bool is_static = topic == "/tf_static";
+    return feed<tf2_msgs::TFMessage>(m, [&comp, is_static](const tf2_msgs::TFMessage::ConstPtr & msg) {
+      for (size_t i = 0; i < msg->transforms.size(); ++i) {
+        tf::StampedTransform transform;
+        tf::transformStampedMsgToTF(msg->transforms[i], transform);
+        comp.add_transform(transform, is_static);
+      }
+    });
+  }
+  return false;
+}
+
+int main(int argc, char ** argv) {
+  std::string input, output, events, dashboard;
+  double control_rate = 10.0;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--output" && i + 1 < argc) {
+      output = argv[++i];
+    } else if (arg == "--control-rate" && i + 1 < argc) {
+      control_rate = std::atof(argv[++i]);
+    } else if (arg == "--events" && i + 1 < argc) {
+      events = argv[++i];
+    } else if (arg == "--dashboard" && i + 1 < argc) {
+      dashboard = argv[++i];
+    } else if (input.empty()) {
+      input = arg;
+    } else {
+      input.clear();
+      break;
+    }
+  }
+  if (input.empty() || control_rate <= 0.0) {
+    std::cerr << "Usage: " << argv[0]
+              << " <input.bag> [--output <commands.bag>] [--control-rate <Hz>] [--events <events.log>]"
+              << " [--dashboard <series.csv>]"
+              << std::endl;
+    return 1;
+  }
+
+  // Simulated time, set from the bag as it is replayed.
+  ros::Time::init();
+
+  rosbag::Bag bag;
+  rosbag::Bag output_bag;
+  try {
+    bag.open(input, rosbag::bagmode::Read);
+    if (!output.empty()) {
+      output_bag.open(output, rosbag::bagmode::Write);
+    }
+  } catch (const rosbag::BagException & ex) {
+    std::cerr << ex.what() << std::endl;
+    return 1;
+  }
+
+  CompetitionConfig config;
+  config.listen_tf = false;       // transforms come from the bag
+  config.gripper_worker = false;  // call the stub services inline, deterministically
+  config.event_log_file = events;
+  config.dashboard_file = dashboard;  // written when the bag's competition state reaches "done", or at the end
+  ReplayTransport transport(output.empty() ? NULL : &output_bag);
+  MyCompetitionClass comp_class(transport, config);
+
+  std::vector<std::string> topics = {
+    "/ariac/joint_states", "/ariac/gripper/state", "/ariac/logical_camera_1",
+    "/ariac/logical_camera_2", "/ariac/orders", "/ariac/current_score",
+    "/ariac/competition_state", "/ariac/break_beam_1_change", "/ariac/proximity_sensor_1",
+    "/ariac/laser_profiler_1", "/tf", "/tf_static",
+  };
+  rosbag::View view(bag, rosbag::TopicQuery(topics));
+
+  const ros::Duration period(1.0 / control_rate);
+  ros::Time first, last, next_tick;
+  size_t messages = 0, ticks = 0, skipped = 0;
+  const ros::WallTime wall_start = ros::WallTime::now();
+  for (rosbag::View::iterator it = view.begin(); it != view.end(); ++it) {
+    const ros::Time stamp = it->getTime();
+    if (messages == 0) {
+      first = stamp;
+      next_tick = stamp;
+      // Warm up inline at the start of the bag, as the node does while waiting for the competition.
+      ros::Time::setNow(stamp);
+      comp_class.warm_up();
+    }
+    // Run the control ticks that fall before this message.
+    while (next_tick <= stamp) {
+      ros::Time::setNow(next_tick);
+      comp_class.control_tick();
+      ++ticks;
+      next_tick += period;
+    }
+    ros::Time::setNow(stamp);
+    if (!dispatch(*it, comp_class)) {
+      ++skipped;
+    }
+    ++messages;
+    last = stamp;
+  }
+  const double wall_time = (ros::WallTime::now() - wall_start).toSec();
+  const double bag_time = (last - first).toSec();
+
+  bag.close();
+  if (!output.empty()) {
+    output_bag.close();
+  }
+
+  std::cout << "messages:        " << messages << " (" << skipped << " not dispatched)\n"
+            << "control ticks:   " << ticks << "\n"
+            << "arm commands:    " << transport.arm_commands() << "\n"
+            << "gripper calls:   " << transport.gripper_calls() << "\n"
+            << "agv calls:       " << transport.agv_calls() << "\n"
+            << "tasks pending:   " << comp_class.pending_tasks() << "\n"
+            << "bag time:        " << bag_time << " s\n"
+            << "wall time:       " << wall_time << " s\n"
+            << "speed-up:        " << (wall_time > 0.0 ? bag_time / wall_time : 0.0) << "x\n\n";
+  comp_class.dashboard().write(std::cout);
+  std::cout << "\n";
+  comp_class.trays().write(std::cout);
+  std::cout << "\n";
+  comp_class.task_states().write(std::cout);
+  std::cout << "\n";
+  comp_class.startup().write(std::cout);
+  std::cout << "\n";
+  comp_class.instrumentation().write(std::cout);
+  std::cout << std::flush;
+  return comp_class.write_series() ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+#include "ariac_example/startup_tracker.h"
+
+#include <iomanip>
+
+StartupTracker::StartupTracker()
+{
+}
+
+bool StartupTracker::mark(Milestone milestone, const ros::Time & now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (now.isZero() || !stamps_[milestone].isZero()) {
+    return false;
+  }
+  stamps_[milestone] = now;
+  return true;
+}
+
+bool StartupTracker::reached(Milestone milestone) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !stamps_[milestone].isZero();
+}
+
+double StartupTracker::since_start(Milestone milestone) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stamps_[milestone].isZero() || stamps_[kStarted].isZero()) {
+    return 0.0;
+  }
+  return (stamps_[milestone] - stamps_[kStarted]).toSec();
+}
+
+void StartupTracker::write(std::ostream & out) const {
+  out << std::left << std::setw(30) << "startup" << std::right << std::setw(12) << "s_to_start" << "\n";
+  for (int i = 0; i < kNumMilestones; ++i) {
+    const Milestone milestone = static_cast<Milestone>(i);
+    out << std::left << std::setw(30) << name(milestone) << std::right << std::setw(12);
+    if (!reached(milestone)) {
+      out << "-" << "\n";
+    } else if (!reached(kStarted)) {
+      out << "?" << "\n";
+    } else {
+      out << std::fixed << std::setprecision(3) << since_start(milestone) << "\n";
+      out.unsetf(std::ios::floatfield);
+    }
+  }
+}
+
+const char * StartupTracker::name(Milestone milestone) {
+  switch (milestone) {
+    case kSubscribed: return "subscribed";
+    case kWarm: return "warm";
+    case kArmReady: return "arm_ready";
+    case kTfReady: return "tf_ready";
+    case kServiceReady: return "service_ready";
+    case kStarted: return "started";
+    case kFirstCommand: return "first_command";
+    default: return "unknown";
+  }
+}
@@ -0,0 +1,142 @@
+#include "ariac_example/task_engine.h"
+
+#include <algorithm>
+#include <ros/ros.h>
+
+TaskEngine::TaskEngine(const WaypointTable & table)
+: table_(table), agvs_(1, 1), next_agv_(0), next_kit_(0), last_goal_(table.ready())
+{
+}
+
+void TaskEngine::set_start(const JointPositions & start) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  last_goal_ = start;
+}
+
+void TaskEngine::set_part_bin(const std::string & part_type, int bin) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  part_bins_[part_type] = bin;
+}
+
+void TaskEngine::set_agvs(const std::vector<int> & agvs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (agvs.empty()) {
+    ROS_ERROR("At least one AGV is needed; keeping the current ones");
+    return;
+  }
+  agvs_ = agvs;
+  next_agv_ = 0;
+}
+
+std::vector<int> TaskEngine::bins() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<int> bins;
+  for (std::map<std::string, int>::const_iterator it = part_bins_.begin(); it != part_bins_.end(); ++it) {
+    if (std::find(bins.begin(), bins.end(), it->second) == bins.end()) {
+      bins.push_back(it->second);
+    }
+  }
+  return bins;
+}
+
+int TaskEngine::add_order(const osrf_gear::Order & order, PlanStats * stats) {
+  // Slots, AGVs and kit numbers are handed out under the lock.
+  std::vector<std::vector<PickPlaceTask> > kits;
+  JointPositions start;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t k = 0; k < order.kits.size(); ++k) {
+      const osrf_gear::Kit & kit = order.kits[k];
+      std::vector<PickPlaceTask> kit_tasks;
+      for (size_t i = 0; i < kit.objects.size(); ++i) {
+        const std::string & part_type = kit.objects[i].type;
+        std::map<std::string, int>::const_iterator bin = part_bins_.find(part_type);
+        if (bin == part_bins_.end()) {
+          ROS_WARN_STREAM("No bin known for part '" << part_type << "', skipping it.");
+          continue;
+        }
+        PickPlaceTask task;
+        task.order_id = order.order_id;
+        task.kit_type = kit.kit_type;
+        task.part_type = part_type;
+        task.bin = bin->second;
+        task.bin_slot = next_bin_slot_[task.bin];
+        task.agv = agvs_[next_agv_];
+        task.tray_slot = static_cast<int>(i);
+        task.kit = next_kit_;
+        if (!table_.pick(task.bin, task.bin_slot, task.pick) ||
+            !table_.place(task.agv, task.tray_slot, task.place_goal)) {
+          ROS_WARN_STREAM("No waypoints for bin " << task.bin << " / agv " << task.agv
+            << ", skipping '" << part_type << "'.");
+          continue;
+        }
+        ++next_bin_slot_[task.bin];
+        kit_tasks.push_back(task);
+      }
+      if (kit_tasks.empty()) {
+        continue;
+      }
+      kits.push_back(kit_tasks);
+      ++next_kit_;
+      next_agv_ = (next_agv_ + 1) % agvs_.size();
+    }
+    start = last_goal_;
+  }
+
+  // Plan without holding the queue; only this thread adds orders, so the start stays valid.
+  std::vector<PickPlaceTask> ordered;
+  for (size_t k = 0; k < kits.size(); ++k) {
+    const std::vector<PickPlaceTask> & kit_tasks = kits[k];
+    std::vector<PickWaypoints> picks(kit_tasks.size());
+    std::vector<JointPositions> places(kit_tasks.size());
+    std::vector<size_t> listed(kit_tasks.size());
+    for (size_t i = 0; i < kit_tasks.size(); ++i) {
+      picks[i] = kit_tasks[i].pick;
+      places[i] = kit_tasks[i].place_goal;
+      listed[i] = i;
+    }
+    std::vector<size_t> planned;
+    const double planned_time = planner_.plan(start, picks, places, planned);
+    if (stats) {
+      stats->planned += planned_time;
+      stats->sequential += planner_.cycle_time(start, picks, places, listed);
+    }
+    for (size_t i = 0; i < planned.size(); ++i) {
+      ordered.push_back(kit_tasks[planned[i]]);
+      ordered.back().kit_parts = static_cast<int>(planned.size());
+      ordered.back().order_kits = static_cast<int>(kits.size());
+    }
+    if (!planned.empty()) {
+      start = ordered.back().place_goal;
+    }
+  }
+
+  // The whole order is queued at once, so the control loop never sees part of it.
+  std::lock_guard<std::mutex> lock(mutex_);
+  tasks_.insert(tasks_.end(), ordered.begin(), ordered.end());
+  if (!ordered.empty()) {
+    last_goal_ = start;
+  }
+  return static_cast<int>(ordered.size());
+}
+
+bool TaskEngine::front(PickPlaceTask & task) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (tasks_.empty()) {
+    return false;
+  }
+  task = tasks_.front();
+  return true;
+}
+
+void TaskEngine::pop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!tasks_.empty()) {
+    tasks_.pop_front();
+  }
+}
+
+size_t TaskEngine::pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return tasks_.size();
+}
@@ -0,0 +1,140 @@
+#include "ariac_example/task_state_machine.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <string>
+
+namespace {
+
+struct StateInfo {
+  const char * name;
+  TaskStates::State parent;
+  uint32_t wakes_on;
+};
+
+// In TaskStates::State order.
+const StateInfo kStateTable[] = {
+  {"startup", TaskStates::kNoState, TaskStates::kArmMoved},
+  {"idle", TaskStates::kNoState, TaskStates::kTaskQueued | TaskStates::kTrayChanged | TaskStates::kTimer},
+  {"task", TaskStates::kNoState, 0},
+  {"pick", TaskStates::kTask, TaskStates::kPartAttached},
+  {"move to bin", TaskStates::kPick, TaskStates::kArmMoved | TaskStates::kTimer},
+  {"grasp in bin", TaskStates::kPick, TaskStates::kTimer},
+  {"wait for part", TaskStates::kPick, TaskStates::kConveyorChanged | TaskStates::kTimer},
+  {"hover over belt", TaskStates::kPick, TaskStates::kArmMoved | TaskStates::kTimer},
+  {"meet part", TaskStates::kPick, TaskStates::kTimer},
+  {"place", TaskStates::kTask, 0},
+  {"move to tray", TaskStates::kPlace, TaskStates::kArmMoved | TaskStates::kPartDetached},
+  {"release", TaskStates::kPlace, TaskStates::kGripperConfirmed | TaskStates::kPartDetached},
+};
+
+static_assert(sizeof(kStateTable) / sizeof(kStateTable[0]) == TaskStates::kNumStates,
+              "one table entry per state");
+
+int depth(TaskStates::State state) {
+  int d = 0;
+  for (TaskStates::State s = TaskStates::parent(state); s != TaskStates::kNoState; s = TaskStates::parent(s)) {
+    ++d;
+  }
+  return d;
+}
+
+}  // namespace
+
+TaskStates::TaskStates()
+: last_from_(kNoState), last_seconds_(0.0), last_timed_out_(false)
+{
+}
+
+const char * TaskStates::name(State state) {
+  return state < kNumStates ? kStateTable[state].name : "none";
+}
+
+const char * TaskStates::name_of(int state) {
+  return state >= 0 ? name(static_cast<State>(state)) : "none";
+}
+
+TaskStates::State TaskStates::parent(State state) {
+  return state < kNumStates ? kStateTable[state].parent : kNoState;
+}
+
+uint32_t TaskStates::wakes_on(State state) {
+  return state < kNumStates ? kStateTable[state].wakes_on : 0;
+}
+
+bool TaskStates::within(State state, State ancestor) {
+  for (State s = state; s != kNoState; s = parent(s)) {
+    if (s == ancestor) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TaskStates::record(State from, State to, const ros::Time & now, bool timed_out) {
+  if (from != kNoState) {
+    last_from_ = from;
+    last_seconds_ = (now - entered_[from]).toSec();
+    last_timed_out_ = timed_out;
+    Edge & edge = timed_out ? timeouts_[from][to] : edges_[from][to];
+    ++edge.count;
+    edge.total += last_seconds_;
+  }
+  // Leave the states that do not hold `to`, innermost first, then enter the new ones.
+  for (State s = from; s != kNoState && !within(to, s); s = parent(s)) {
+    const double seconds = (now - entered_[s]).toSec();
+    ++stats_[s].visits;
+    stats_[s].total += seconds;
+    stats_[s].max = std::max(stats_[s].max, seconds);
+  }
+  for (State s = to; s != kNoState && !within(from, s); s = parent(s)) {
+    entered_[s] = now;
+  }
+}
+
+void TaskStates::write(std::ostream & out) const {
+  // Top-level states partition the run, so their sum is the time accounted for.
+  double run = 0.0;
+  for (int i = 0; i < kNumStates; ++i) {
+    if (parent(static_cast<State>(i)) == kNoState) {
+      run += stats_[i].total;
+    }
+  }
+  out << std::fixed << std::setprecision(3);
+  out << std::left << std::setw(30) << "state" << std::right
+      << std::setw(10) << "visits" << std::setw(12) << "total_s" << std::setw(12) << "mean_s"
+      << std::setw(12) << "max_s" << std::setw(10) << "share" << "\n";
+  for (int i = 0; i < kNumStates; ++i) {
+    const State state = static_cast<State>(i);
+    const Stats & s = stats_[i];
+    if (s.visits == 0) {
+      continue;
+    }
+    const std::string label = std::string(2 * depth(state), ' ') + name(state);
+    out << std::left << std::setw(30) << label << std::right
+        << std::setw(10) << s.visits
+        << std::setw(12) << s.total
+        << std::setw(12) << s.total / s.visits
+        << std::setw(12) << s.max
+        << std::setw(9) << std::setprecision(1) << (run > 0.0 ? 100.0 * s.total / run : 0.0) << "%"
+        << std::setprecision(3) << "\n";
+  }
+  out << "\n" << std::left << std::setw(40) << "transition" << std::right
+      << std::setw(10) << "count" << std::setw(12) << "mean_s" << "\n";
+  for (int from = 0; from < kNumStates; ++from) {
+    for (int to = 0; to < kNumStates; ++to) {
+      for (int timed_out = 0; timed_out < 2; ++timed_out) {
+        const Edge & edge = timed_out ? timeouts_[from][to] : edges_[from][to];
+        if (edge.count == 0) {
+          continue;
+        }
+        const std::string label = std::string(name(static_cast<State>(from))) + " -> " +
+          name(static_cast<State>(to)) + (timed_out ? " (timeout)" : "");
+        out << std::left << std::setw(40) << label << std::right
+            << std::setw(10) << edge.count << std::setw(12) << edge.total / edge.count << "\n";
+      }
+    }
+  }
+  out.unsetf(std::ios::floatfield);
+  out << std::setprecision(6);
+}
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <ros/ros.h>
+#include <rosbag/bag.h>
+#include <rosbag/view.h>
+#include <tf/transform_datatypes.h>
+#include <tf2_msgs/TFMessage.h>
+
+#include "ariac_example/tf_cache.h"
+
+/*
+ * Benchmark for the TF lookups of the grasp/place checks, on the /tf and
+ * /tf_static stream of a recorded bag. At every control tick in bag time,
+ * the gripper is located relative to each bin and tray frame two ways:
+ *
+ *  - blocking: as the node used to, with a fresh listener per check that
+ *    gets the latched static transforms, then waits for /tf until it can
+ *    transform (at most 10 s) and calls lookupTransform;
+ *  - cached: TfCache::lookup() on one transformer fed the whole stream.
+ *
+ * The blocking wait is the bag time until the stream completes the chain;
+ * CPU time is measured for both.
+ *
+ * Usage: ariac_example_tf_benchmark <input.bag> [lookup rate (Hz)] [blocking checks]
+ */
+
+namespace {
+
+const char * const kTargets[] = {
+  "/bin6_frame", "/bin7_frame", "/agv1_load_point_frame", "/agv2_load_point_frame"
+};
+const size_t kNumTargets = sizeof(kTargets) / sizeof(kTargets[0]);
+const char * const kSource = "/vacuum_gripper_link";
+const double kWaitTimeout = 10.0;  // s, what the old waitForTransform() allowed
+
+struct Recorded {
+  ros::Time stamp;
+  bool is_static;
+  tf2_msgs::TFMessage::ConstPtr msg;
+};
+
+void add(tf::Transformer & transformer, const Recorded & recorded) {
+  for (size_t i = 0; i < recorded.msg->transforms.size(); ++i) {
+    transformer.getTF2BufferPtr()->setTransform(recorded.msg->transforms[i], "replay", recorded.is_static);
+  }
+}
+
+void add(TfCache & cache, const Recorded & recorded) {
+  for (size_t i = 0; i < recorded.msg->transforms.size(); ++i) {
+    tf::StampedTransform transform;
+    tf::transformStampedMsgToTF(recorded.msg->transforms[i], transform);
+    cache.add_transform(transform, recorded.is_static);
+  }
+}
+
+struct Stats {
+  size_t lookups = 0;
+  size_t failed = 0;
+  std::vector<double> cpu;  ///< s per lookup
+  double wait = 0.0;        ///< bag s, summed
+  double wait_max = 0.0;
+
+  void write(const char * name) {
+    std::sort(cpu.begin(), cpu.end());
+    double total = 0.0;
+    for (size_t i = 0; i < cpu.size(); ++i) {
+      total += cpu[i];
+    }
+    const double p99 = cpu.empty() ? 0.0 : cpu[std::min(cpu.size() - 1, cpu.size() * 99 / 100)];
+    std::cout << std::fixed << std::left << std::setw(10) << name << std::right
+              << std::setw(9) << lookups << std::setw(8) << failed << std::setprecision(1)
+              << std::setw(12) << (cpu.empty() ? 0.0 : 1e6 * total / cpu.size())
+              << std::setw(12) << 1e6 * p99 << std::setprecision(3)
+              << std::setw(12) << (lookups > 0 ? 1e3 * wait / lookups : 0.0)
+              << std::setw(12) << 1e3 * wait_max << "\n";
+  }
+};
+
+}  // namespace
+
+int main(int argc, char ** argv) {
+  const std::string input = argc > 1 ? argv[1] : "";
+  const double rate = argc > 2 ? std::atof(argv[2]) : 10.0;
+  const int blocking_checks = argc > 3 ? std::atoi(argv[3]) : 200;
+  if (input.empty() || rate <= 0.0 || blocking_checks < 0) {
+    std::cerr << "Usage: " << argv[0] << " <input.bag> [lookup rate (Hz)] [blocking checks]" << std::endl;
+    return 1;
+  }
+
+  // Simulated time, so the cache's freshness limit follows the bag.
+  ros::Time::init();
+
+  std::vector<Recorded> stream;
+  try {
+    rosbag::Bag bag;
+    bag.open(input, rosbag::bagmode::Read);
+    std::vector<std::string> topics = {"/tf", "/tf_static"};
+    rosbag::View view(bag, rosbag::TopicQuery(topics));
+    for (rosbag::View::iterator it = view.begin(); it != view.end(); ++it) {
+      Recorded recorded;
+      recorded.stamp = it->getTime();
+      recorded.is_static = it->getTopic() == "/tf_static";
+      recorded.msg = it->instantiate<tf2_msgs::TFMessage>();
+      if (recorded.msg) {
+        stream.push_back(recorded);
+      }
+    }
+    bag.close();
+  } catch (const rosbag::BagException & ex) {
+    std::cerr << ex.what() << std::endl;
+    return 1;
+  }
+  if (stream.empty()) {
+    std::cerr << "No /tf messages in " << input << std::endl;
+    return 1;
+  }
+  const ros::Duration period(1.0 / rate);
+  const ros::Time first = stream.front().stamp, last = stream.back().stamp;
+  std::cout << stream.size() << " /tf messages over " << (last - first).toSec() << " s, lookups at "
+            << rate << " Hz" << std::endl;
+
+  // Cached: one transformer fed as the stream goes by, looked up at every tick.
+  Stats cached;
+  {
+    TfCache cache(false);
+    int pairs[kNumTargets];
+    for (size_t t = 0; t < kNumTargets; ++t) {
+      pairs[t] = cache.add_frame_pair(kTargets[t], kSource);
+    }
+    size_t next = 0;
+    for (ros::Time tick = first; tick <= last; tick += period) {
+      for (; next < stream.size() && stream[next].stamp <= tick; ++next) {
+        add(cache, stream[next]);
+      }
+      ros::Time::setNow(tick);
+      for (size_t t = 0; t < kNumTargets; ++t) {
+        tf::StampedTransform transform;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const bool found = cache.lookup(pairs[t], transform);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        ++cached.lookups;
+        cached.failed += !found;
+        cached.cpu.push_back(elapsed.count());
+      }
+    }
+  }
+
+  // Blocking: a fresh transformer per check, spread evenly over the bag.
+  Stats blocking;
+  const double span = (last - first).toSec();
+  for (int c = 0; c < blocking_checks; ++c) {
+    const ros::Time tick = first + ros::Duration(span * c / std::max(blocking_checks, 1));
+    const std::string & target = kTargets[c % kNumTargets];
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    tf::Transformer transformer(true, ros::Duration(kWaitTimeout));
+    // A new listener gets the latched static transforms as soon as it subscribes.
+    size_t next = 0;
+    for (; next < stream.size() && stream[next].stamp <= tick; ++next) {
+      if (stream[next].is_static) {
+        add(transformer, stream[next]);
+      }
+    }
+    bool found = transformer.canTransform(target, kSource, ros::Time(0));
+    ros::Time arrived = tick;
+    for (; !found && next < stream.size() && (stream[next].stamp - tick).toSec() <= kWaitTimeout; ++next) {
+      add(transformer, stream[next]);
+      arrived = stream[next].stamp;
+      found = transformer.canTransform(target, kSource, ros::Time(0));
+    }
+    tf::StampedTransform transform;
+    if (found) {
+      try {
+        transformer.lookupTransform(target, kSource, ros::Time(0), transform);
+      } catch (const tf::TransformException & ex) {
+        found = false;
+      }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double wait = found ? (arrived - tick).toSec() : kWaitTimeout;
+    ++blocking.lookups;
+    blocking.failed += !found;
+    blocking.cpu.push_back(elapsed.count());
+    blocking.wait += wait;
+    blocking.wait_max = std::max(blocking.wait_max, wait);
+  }
+
+  std::cout << std::left << std::setw(10) << "method" << std::right << std::setw(9) << "lookups"
+            << std::setw(8) << "failed" << std::setw(12) << "cpu_us" << std::setw(12) << "cpu_p99_us"
+            << std::setw(12) << "wait_ms" << std::setw(12) << "wait_max_ms" << "\n";
+  blocking.write("blocking");
+  cached.write("cached");
+  return 0;
+}
@@ -0,0 +1,102 @@
+#include "ariac_example/tf_cache.h"
+
+#include <limits>
+
+TfCache::TfCache(bool listen, const ros::Duration & max_age)
+: listening_(listen), max_age_(max_age)
+{
+  if (listen) {
+    transformer_.reset(new tf::TransformListener());
+  } else {
+    transformer_.reset(new tf::Transformer());
+  }
+  changed_ = transformer_->addTransformsChangedListener([this]() { ++changes_; });
+}
+
+TfCache::~TfCache() {
+  transformer_->removeTransformsChangedListener(changed_);
+}
+
+void TfCache::add_transform(const tf::StampedTransform & transform, bool is_static) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Go through the tf2 buffer so static transforms stay valid at every time.
+  geometry_msgs::TransformStamped msg;
+  tf::transformStampedTFToMsg(transform, msg);
+  transformer_->getTF2BufferPtr()->setTransform(msg, "replay", is_static);
+}
+
+int TfCache::add_frame_pair(const std::string & target_frame, const std::string & source_frame) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FramePair pair;
+  if (listening_) {
+    // Applies the tf_prefix parameter, if any.
+    tf::TransformListener & listener = static_cast<tf::TransformListener &>(*transformer_);
+    pair.target = listener.resolve(target_frame);
+    pair.source = listener.resolve(source_frame);
+  } else {
+    pair.target = tf::resolve("", target_frame);
+    pair.source = tf::resolve("", source_frame);
+  }
+  // tf2 names frames without the leading slash; strip it once here rather than on every lookup.
+  pair.target_id = tf::strip_leading_slash(pair.target);
+  pair.source_id = tf::strip_leading_slash(pair.source);
+  pair.valid = false;
+  pair.changes = std::numeric_limits<size_t>::max();
+  pairs_.push_back(pair);
+  return static_cast<int>(pairs_.size()) - 1;
+}
+
+bool TfCache::is_fresh(const tf::StampedTransform & transform) const {
+  // A zero max age disables the freshness check (static transforms).
+  if (max_age_.isZero()) {
+    return true;
+  }
+  return (ros::Time::now() - transform.stamp_) < max_age_;
+}
+
+bool TfCache::refresh(int pair) {
+  if (pair < 0 || pair >= static_cast<int>(pairs_.size())) {
+    ROS_ERROR_STREAM("TfCache: unknown frame pair " << pair);
+    return false;
+  }
+  FramePair & entry = pairs_[pair];
+  // Never wait here: only take what the listener already has buffered. A lookup copies the frame
+  // names into a new message, so it is only made when a transform has arrived since the last one.
+  const size_t changes = changes_.load();
+  if (changes != entry.changes) {
+    entry.changes = changes;
+    tf2::BufferCore & core = *transformer_->getTF2BufferPtr();
+    try {
+      if (core.canTransform(entry.target_id, entry.source_id, ros::Time(0))) {
+        tf::transformStampedMsgToTF(core.lookupTransform(entry.target_id, entry.source_id, ros::Time(0)),
+          entry.last);
+        entry.valid = true;
+      }
+    } catch (const tf2::TransformException & ex) {
+      ROS_WARN_STREAM_THROTTLE(1, "TfCache: " << ex.what());
+    }
+  }
+  return entry.valid && is_fresh(entry.last);
+}
+
+bool TfCache::lookup(int pair, tf::StampedTransform & transform) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!refresh(pair)) {
+    return false;
+  }
+  transform = pairs_[pair].last;
+  return true;
+}
+
+bool TfCache::lookup_origin(int pair, geometry_msgs::Point & origin) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Read the origin in place: copying the transform would copy its frame names too.
+  if (!refresh(pair)) {
+    return false;
+  }
+  const tf::Vector3 & translation = pairs_[pair].last.getOrigin();
+  origin.x = translation.x();
+  origin.y = translation.y();
+  origin.z = translation.z();
+  return true;
+}
@@ -0,0 +1,243 @@
+#include "ariac_example/throughput_dashboard.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+diagnostic_msgs::KeyValue key_value(const std::string & key, double value) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3) << value;
+  diagnostic_msgs::KeyValue kv;
+  kv.key = key;
+  kv.value = out.str();
+  return kv;
+}
+
+}  // namespace
+
+ThroughputDashboard::ThroughputDashboard(double sample_period, size_t max_samples)
+: sample_period_(sample_period), activity_(kStarting), score_(0.0), parts_(0), kits_(0),
+  cycles_(0), cycle_total_(0.0), cycle_min_(0.0), cycle_max_(0.0), max_samples_(std::max<size_t>(max_samples, 1)),
+  oldest_(0)
+{
+  seconds_.fill(0.0);
+  samples_.reserve(max_samples_);
+}
+
+void ThroughputDashboard::start(const ros::Time & now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!start_.isZero()) {
+    return;
+  }
+  start_ = now;
+  last_update_ = now;
+  next_sample_ = now;
+}
+
+void ThroughputDashboard::activity(Activity activity, const ros::Time & now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  advance(now);
+  activity_ = activity;
+  if (!start_.isZero() && now >= next_sample_) {
+    push(now, -1);
+    next_sample_ = now + ros::Duration(sample_period_);
+  }
+}
+
+void ThroughputDashboard::part_started(const ros::Time & now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (part_start_.isZero()) {
+    part_start_ = now;
+  }
+}
+
+void ThroughputDashboard::part_placed(const ros::Time & now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++parts_;
+  last_part_ = now;
+  if (part_start_.isZero()) {
+    return;
+  }
+  const double cycle = (now - part_start_).toSec();
+  cycle_total_ += cycle;
+  cycle_min_ = ++cycles_ == 1 ? cycle : std::min(cycle_min_, cycle);
+  cycle_max_ = std::max(cycle_max_, cycle);
+  part_start_ = ros::Time();
+}
+
+void ThroughputDashboard::kit_submitted(const ros::Time & now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++kits_;
+  last_kit_ = now;
+}
+
+void ThroughputDashboard::score(double score, const ros::Time & now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const double points = score - score_;
+  score_ = score;
+  if (points == 0.0) {
+    return;
+  }
+  // Credit the change to whatever the node finished last.
+  Cause cause = kUnknown;
+  ros::Time event;
+  if (!last_kit_.isZero() && last_kit_ >= last_part_) {
+    cause = kKit;
+    event = last_kit_;
+  } else if (!last_part_.isZero()) {
+    cause = kPart;
+    event = last_part_;
+  }
+  Credit & credit = credits_[cause];
+  ++credit.count;
+  credit.points += points;
+  if (cause != kUnknown) {
+    credit.latency += (now - event).toSec();
+  }
+  advance(now);
+  if (!start_.isZero()) {
+    push(now, cause);
+  }
+}
+
+double ThroughputDashboard::points_per_minute(const ros::Time & now) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const double m = minutes(now);
+  return m > 0.0 ? score_ / m : 0.0;
+}
+
+void ThroughputDashboard::fill(diagnostic_msgs::DiagnosticArray & diagnostics, const ros::Time & now) const {
+  const double rate = points_per_minute(now);
+  std::lock_guard<std::mutex> lock(mutex_);
+  diagnostic_msgs::DiagnosticStatus status;
+  status.level = diagnostic_msgs::DiagnosticStatus::OK;
+  status.name = "ariac_example: throughput";
+  status.hardware_id = "ariac_example";
+  status.values.push_back(key_value("score", score_));
+  status.values.push_back(key_value("points_per_min", rate));
+  status.values.push_back(key_value("parts", parts_));
+  status.values.push_back(key_value("kits", kits_));
+  status.values.push_back(key_value("cycle_mean_s", cycles_ > 0 ? cycle_total_ / cycles_ : 0.0));
+  for (int i = 0; i < kNumActivities; ++i) {
+    status.values.push_back(key_value(std::string(name(static_cast<Activity>(i))) + "_s", seconds_[i]));
+  }
+  diagnostics.status.push_back(status);
+}
+
+void ThroughputDashboard::write(std::ostream & out) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const double m = minutes(last_update_);
+  double total = 0.0;
+  for (int i = 0; i < kNumActivities; ++i) {
+    total += seconds_[i];
+  }
+  out << std::fixed << std::setprecision(2);
+  out << "score:             " << score_ << "\n"
+      << "points per minute: " << (m > 0.0 ? score_ / m : 0.0) << "\n"
+      << "parts placed:      " << parts_ << "\n"
+      << "kits submitted:    " << kits_ << "\n";
+  if (cycles_ > 0) {
+    out << "part cycle:        " << cycle_total_ / cycles_ << " s mean, " << cycle_min_ << " min, "
+        << cycle_max_ << " max\n";
+  }
+  for (int i = 0; i < kNumCauses; ++i) {
+    const Credit & credit = credits_[i];
+    if (credit.count == 0) {
+      continue;
+    }
+    out << std::left << std::setw(19) << std::string("score from ") + name(static_cast<Cause>(i)) + ":"
+        << std::right << credit.points << " points in " << credit.count << " changes";
+    if (i != kUnknown) {
+      out << ", " << credit.latency / credit.count << " s after it";
+    }
+    out << "\n";
+  }
+  out << "time waiting on:\n";
+  for (int i = 0; i < kNumActivities; ++i) {
+    out << "  " << std::left << std::setw(17) << name(static_cast<Activity>(i)) << std::right
+        << std::setw(10) << seconds_[i] << " s" << std::setw(8) << std::setprecision(1)
+        << (total > 0.0 ? 100.0 * seconds_[i] / total : 0.0) << "%" << std::setprecision(2) << "\n";
+  }
+  out.unsetf(std::ios::floatfield);
+  out << std::setprecision(6);
+}
+
+bool ThroughputDashboard::write_series(const std::string & path) const {
+  std::ofstream out(path.c_str());
+  if (!out) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  out << "t_s,score,parts,kits,points_per_min,cycle_mean_s";
+  for (int i = 0; i < kNumActivities; ++i) {
+    out << "," << name(static_cast<Activity>(i)) << "_s";
+  }
+  out << ",cause\n";
+  out << std::fixed << std::setprecision(3);
+  for (size_t i = 0; i < samples_.size(); ++i) {
+    const Sample & s = samples_[(oldest_ + i) % samples_.size()];
+    out << s.t << "," << s.score << "," << s.parts << "," << s.kits << ","
+        << (s.t > 0.0 ? 60.0 * s.score / s.t : 0.0) << "," << s.cycle_mean;
+    for (int a = 0; a < kNumActivities; ++a) {
+      out << "," << s.seconds[a];
+    }
+    out << "," << (s.cause >= 0 ? name(static_cast<Cause>(s.cause)) : "") << "\n";
+  }
+  return static_cast<bool>(out);
+}
+
+const char * ThroughputDashboard::name(Activity activity) {
+  switch (activity) {
+    case kStarting: return "starting";
+    case kNoOrder: return "no_order";
+    case kTrayAway: return "tray_away";
+    case kMotion: return "motion";
+    case kTf: return "tf";
+    case kGripper: return "gripper";
+    case kSensors: return "sensors";
+    default: return "unknown";
+  }
+}
+
+const char * ThroughputDashboard::name(Cause cause) {
+  switch (cause) {
+    case kPart: return "part";
+    case kKit: return "kit";
+    default: return "unknown";
+  }
+}
+
+void ThroughputDashboard::advance(const ros::Time & now) {
+  if (start_.isZero()) {
+    last_update_ = now;
+    return;
+  }
+  if (now > last_update_) {
+    seconds_[activity_] += (now - last_update_).toSec();
+    last_update_ = now;
+  }
+}
+
+void ThroughputDashboard::push(const ros::Time & now, int cause) {
+  Sample sample;
+  sample.t = (now - start_).toSec();
+  sample.score = score_;
+  sample.parts = parts_;
+  sample.kits = kits_;
+  sample.cycle_mean = cycles_ > 0 ? cycle_total_ / cycles_ : 0.0;
+  sample.seconds = seconds_;
+  sample.cause = cause;
+  if (samples_.size() < max_samples_) {
+    samples_.push_back(sample);
+  } else {
+    samples_[oldest_] = sample;
+    oldest_ = (oldest_ + 1) % max_samples_;
+  }
+}
+
+double ThroughputDashboard::minutes(const ros::Time & now) const {
+  return start_.isZero() ? 0.0 : (now - start_).toSec() / 60.0;
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ariac_example/trajectory_timing.h"
+#include "ariac_example/waypoint_table.h"
+
+/*
+ * Benchmark for segment timing: the trapezoidal timing against the fixed
+ * durations the node used to command, and against velocity-only timing,
+ * over the legs of one pick-and-place cycle for every bin and tray in the
+ * waypoint table.
+ *
+ * A fixed duration shorter than the arm can manage at its full limits is
+ * not what the arm does: it lags until it gets there. So besides the
+ * commanded time, each fixed leg is also given the least time it can
+ * really take, and flagged when its command exceeds the limits.
+ *
+ * Usage: ariac_example_timing_benchmark [limit scale] [fixed segment time (s)]
+ */
+
+namespace {
+
+struct Leg {
+  std::string name;
+  const JointPositions * from;
+  const JointPositions * to;
+};
+
+/// Time with each joint at its velocity limit, ignoring acceleration, as before the trapezoidal timing.
+double velocity_only(const TrajectoryTiming & timing, double scale, const JointPositions & from,
+                     const JointPositions & to, double min_segment_time) {
+  double duration = min_segment_time;
+  for (size_t i = 0; i < kNumArmJoints; ++i) {
+    duration = std::max(duration, std::fabs(to[i] - from[i]) / (timing.max_velocity()[i] * scale));
+  }
+  return duration;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv) {
+  const double scale = argc > 1 ? std::atof(argv[1]) : 0.5;
+  const double fixed = argc > 2 ? std::atof(argv[2]) : 0.3;
+  if (scale <= 0.0 || scale > 1.0 || fixed <= 0.0) {
+    std::cerr << "Usage: " << argv[0] << " [limit scale] [fixed segment time (s)]" << std::endl;
+    return 1;
+  }
+  const double min_segment_time = 0.1;
+
+  TrajectoryTiming full;  // what the arm can do at most
+  full.set_min_segment_time(0.0);
+  TrajectoryTiming timing;
+  timing.set_limits(timing.max_velocity(), timing.max_acceleration(), scale);
+  timing.set_min_segment_time(min_segment_time);
+
+  WaypointTable waypoints;
+  std::cout << std::left << std::setw(34) << "leg" << std::right << std::setw(9) << "fixed_s"
+            << std::setw(10) << "lags_to_s" << std::setw(10) << "over_x" << std::setw(12) << "velocity_s"
+            << std::setw(13) << "trapezoid_s" << "\n";
+
+  const int bins[] = {6, 7, WaypointTable::kConveyor};
+  const int agvs[] = {1, 2};
+  double total_fixed = 0.0, total_lag = 0.0, total_velocity = 0.0, total_trapezoid = 0.0;
+  size_t over = 0, legs_timed = 0;
+  for (size_t b = 0; b < sizeof(bins) / sizeof(bins[0]); ++b) {
+    for (size_t a = 0; a < sizeof(agvs) / sizeof(agvs[0]); ++a) {
+      PickWaypoints pick;
+      JointPositions place;
+      if (!waypoints.pick(bins[b], 0, pick) || !waypoints.place(agvs[a], 0, place)) {
+        continue;
+      }
+      const std::string bin = bins[b] == WaypointTable::kConveyor ? "belt" : "bin" + std::to_string(bins[b]);
+      const std::string agv = "agv" + std::to_string(agvs[a]);
+      // One cycle from the ready pose, as for the first part of a kit.
+      const Leg legs[] = {
+        {"ready -> " + bin + " approach", &waypoints.ready(), &pick.approach},
+        {bin + " approach -> grasp", &pick.approach, &pick.grasp},
+        {bin + " grasp -> approach", &pick.grasp, &pick.approach},
+        {bin + " approach -> " + agv, &pick.approach, &place},
+      };
+      double cycle_fixed = 0.0, cycle_lag = 0.0, cycle_velocity = 0.0, cycle_trapezoid = 0.0;
+      for (size_t l = 0; l < sizeof(legs) / sizeof(legs[0]); ++l) {
+        const Leg & leg = legs[l];
+        const double least = full.segment_time(*leg.from, *leg.to);
+        const double lag = std::max(fixed, least);
+        const double velocity = velocity_only(timing, scale, *leg.from, *leg.to, min_segment_time);
+        const double trapezoid = timing.segment_time(*leg.from, *leg.to);
+        std::cout << std::fixed << std::setprecision(2) << std::left << std::setw(34) << leg.name
+                  << std::right << std::setw(9) << fixed << std::setw(10) << lag
+                  << std::setw(10) << least / fixed << std::setw(12) << velocity
+                  << std::setw(13) << trapezoid << "\n";
+        cycle_fixed += fixed;
+        cycle_lag += lag;
+        cycle_velocity += velocity;
+        cycle_trapezoid += trapezoid;
+        over += least > fixed;
+        ++legs_timed;
+      }
+      std::cout << std::left << std::setw(34) << ("  cycle " + bin + " -> " + agv) << std::right
+                << std::setw(9) << cycle_fixed << std::setw(10) << cycle_lag << std::setw(10) << ""
+                << std::setw(12) << cycle_velocity << std::setw(13) << cycle_trapezoid << "\n";
+      total_fixed += cycle_fixed;
+      total_lag += cycle_lag;
+      total_velocity += cycle_velocity;
+      total_trapezoid += cycle_trapezoid;
+    }
+  }
+  std::cout << "\n" << over << "/" << legs_timed << " fixed legs command more than the joint limits allow\n"
+            << "all cycles: fixed " << total_fixed << " s commanded, " << total_lag << " s at the limits; "
+            << "velocity-only " << total_velocity << " s; trapezoidal " << total_trapezoid << " s at "
+            << scale << " of the limits" << std::endl;
+  return 0;
+}
@@ -0,0 +1,62 @@
+#include "ariac_example/trajectory_builder.h"
+
+#include <utility>
+#include <ros/ros.h>
+
+TrajectoryBuilder::TrajectoryBuilder()
+{
+  // Build the message template once; build() only overwrites positions and times.
+  traj_.joint_names = arm_joint_names();
+  traj_.points.reserve(kMaxPoints);
+  spare_points_.reserve(kMaxPoints);
+  spare_points_.resize(kMaxPoints);
+  for (size_t i = 0; i < spare_points_.size(); ++i) {
+    spare_points_[i].positions.reserve(kNumArmJoints);
+  }
+}
+
+void TrajectoryBuilder::set_point_count(size_t count) {
+  while (traj_.points.size() > count) {
+    spare_points_.push_back(std::move(traj_.points.back()));
+    traj_.points.pop_back();
+  }
+  while (traj_.points.size() < count) {
+    if (spare_points_.empty()) {
+      // More than kMaxPoints waypoints: fall back to allocating.
+      traj_.points.push_back(trajectory_msgs::JointTrajectoryPoint());
+      continue;
+    }
+    traj_.points.push_back(std::move(spare_points_.back()));
+    spare_points_.pop_back();
+  }
+}
+
+trajectory_msgs::JointTrajectory & TrajectoryBuilder::build(
+  const JointPositions & start, std::initializer_list<const JointPositions *> waypoints)
+{
+  return fill(start, waypoints.begin(), waypoints.end(), waypoints.size());
+}
+
+trajectory_msgs::JointTrajectory & TrajectoryBuilder::build(
+  const JointPositions & start, const std::vector<const JointPositions *> & waypoints)
+{
+  return fill(start, waypoints.begin(), waypoints.end(), waypoints.size());
+}
+
+template <class Iterator>
+trajectory_msgs::JointTrajectory & TrajectoryBuilder::fill(
+  const JointPositions & start, Iterator begin, Iterator end, size_t count)
+{
+  set_point_count(count);
+  const JointPositions * previous = &start;
+  double time_from_start = 0.0;
+  size_t i = 0;
+  for (Iterator it = begin; it != end; ++it, ++i) {
+    time_from_start += timing_.segment_time(*previous, **it);
+    // Assigning into the recycled buffer reuses its capacity.
+    traj_.points[i].positions.assign((*it)->begin(), (*it)->end());
+    traj_.points[i].time_from_start = ros::Duration(time_from_start);
+    previous = *it;
+  }
+  return traj_;
+}
@@ -0,0 +1,60 @@
+#include "ariac_example/trajectory_timing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ros/ros.h>
+
+TrajectoryTiming::TrajectoryTiming()
+: min_segment_time_(0.1)
+{
+  // Order: elbow, linear_arm_actuator, shoulder_lift, shoulder_pan, wrist_1, wrist_2, wrist_3.
+  // Velocities are the UR10 URDF limits; accelerations are conservative guesses.
+  max_velocity_ = {3.15, 1.0, 2.16, 2.16, 3.2, 3.2, 3.2};
+  max_acceleration_ = {3.0, 1.0, 2.0, 2.0, 4.0, 4.0, 4.0};
+  scaled_velocity_ = max_velocity_;
+  scaled_acceleration_ = max_acceleration_;
+}
+
+bool TrajectoryTiming::set_limits(const std::vector<double> & max_velocity,
+                                  const std::vector<double> & max_acceleration, double scale) {
+  if (max_velocity.size() != max_velocity_.size() || max_acceleration.size() != max_acceleration_.size() ||
+      scale <= 0.0) {
+    ROS_ERROR_STREAM("Ignoring joint limits: expected " << max_velocity_.size()
+      << " velocity and acceleration limits and a positive scale.");
+    return false;
+  }
+  for (size_t i = 0; i < max_velocity.size(); ++i) {
+    if (max_velocity[i] <= 0.0 || max_acceleration[i] <= 0.0) {
+      ROS_ERROR_STREAM("Ignoring joint limits: limit " << i << " is not positive.");
+      return false;
+    }
+  }
+  scale = std::min(scale, 1.0);
+  max_velocity_ = max_velocity;
+  max_acceleration_ = max_acceleration;
+  for (size_t i = 0; i < max_velocity_.size(); ++i) {
+    scaled_velocity_[i] = max_velocity_[i] * scale;
+    // Scaling the acceleration by scale^2 keeps the profile shape.
+    scaled_acceleration_[i] = max_acceleration_[i] * scale * scale;
+  }
+  return true;
+}
+
+double TrajectoryTiming::rest_to_rest_time(double distance, double max_velocity, double max_acceleration) {
+  distance = std::fabs(distance);
+  // Distance covered while accelerating to full speed and braking again.
+  const double ramp_distance = max_velocity * max_velocity / max_acceleration;
+  if (distance < ramp_distance) {
+    return 2.0 * std::sqrt(distance / max_acceleration);
+  }
+  return distance / max_velocity + max_velocity / max_acceleration;
+}
+
+double TrajectoryTiming::segment_time(const JointPositions & from, const JointPositions & to) const {
+  double duration = min_segment_time_;
+  for (size_t i = 0; i < kNumArmJoints; ++i) {
+    duration = std::max(duration,
+      rest_to_rest_time(to[i] - from[i], scaled_velocity_[i], scaled_acceleration_[i]));
+  }
+  return duration;
+}
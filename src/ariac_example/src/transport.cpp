@@ -0,0 +1,31 @@
+#include "ariac_example/transport.h"
+
+RosTransport::RosTransport(ros::NodeHandle & node)
+{
+  joint_trajectory_publisher_ = node.advertise<trajectory_msgs::JointTrajectory>(
+    "/ariac/arm/command", 10);
+  diagnostics_publisher_ = node.advertise<diagnostic_msgs::DiagnosticArray>("/diagnostics", 1);
+  gripper_service_ = node.serviceClient<osrf_gear::VacuumGripperControl>("/ariac/gripper/control");
+  agv_services_[0] = node.serviceClient<osrf_gear::AGVControl>("/ariac/agv1");
+  agv_services_[1] = node.serviceClient<osrf_gear::AGVControl>("/ariac/agv2");
+}
+
+void RosTransport::publish_arm_command(const trajectory_msgs::JointTrajectory & traj) {
+  joint_trajectory_publisher_.publish(traj);
+}
+
+bool RosTransport::call_gripper(osrf_gear::VacuumGripperControl & srv) {
+  return gripper_service_.call(srv);
+}
+
+bool RosTransport::call_agv(int agv, osrf_gear::AGVControl & srv) {
+  if (agv < 1 || agv > 2) {
+    ROS_ERROR_STREAM("There is no agv" << agv);
+    return false;
+  }
+  return agv_services_[agv - 1].call(srv);
+}
+
+void RosTransport::publish_diagnostics(const diagnostic_msgs::DiagnosticArray & diagnostics) {
+  diagnostics_publisher_.publish(diagnostics);
+}
@@ -0,0 +1,253 @@
+#include "ariac_example/tray_manager.h"
+
+#include <iomanip>
+
+namespace {
+
+// How long the camera may lag the last placement before the kit is submitted anyway.
+const double kConfirmTimeout = 2.0;
+// Wait between failed AGV calls.
+const double kRetryInterval = 1.0;
+
+}  // namespace
+
+TrayManager::TrayManager(Transport & transport, bool use_worker, const ros::Duration & transit)
+: transport_(transport), transit_(transit.toSec()), changes_(0), kits_submitted_(0), orders_completed_(0),
+  running_(use_worker)
+{
+  if (use_worker) {
+    worker_ = std::thread(&TrayManager::run, this);
+  }
+}
+
+TrayManager::~TrayManager() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  changed_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+void TrayManager::set_camera(int agv) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  trays_[agv].watched = true;
+}
+
+bool TrayManager::available(int agv, int kit) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::map<int, Tray>::const_iterator it = trays_.find(agv);
+  if (it == trays_.end()) {
+    return true;  // Never used yet.
+  }
+  return it->second.phase == kIdle || (it->second.phase == kFilling && it->second.kit == kit);
+}
+
+void TrayManager::start_kit(const PickPlaceTask & task, const ros::Time & now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Tray & tray = trays_[task.agv];
+  if (tray.phase != kIdle) {
+    return;
+  }
+  tray.phase = kFilling;
+  ++changes_;
+  tray.kit = task.kit;
+  tray.order_id = task.order_id;
+  tray.kit_type = task.kit_type;
+  tray.order_kits = task.order_kits;
+  tray.expected = task.kit_parts;
+  tray.placed = 0;
+  tray.since = now;
+  if (first_start_.isZero()) {
+    first_start_ = now;
+  }
+}
+
+void TrayManager::placed(int agv, const ros::Time & now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Tray & tray = trays_[agv];
+  if (tray.phase == kFilling && ++tray.placed == tray.expected) {
+    tray.since = now;  // The camera has kConfirmTimeout from here to see them all.
+  }
+}
+
+void TrayManager::skipped(int agv, const ros::Time & now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Tray & tray = trays_[agv];
+  if (tray.phase == kFilling && tray.expected > 0 && tray.placed == --tray.expected) {
+    tray.since = now;
+  }
+}
+
+void TrayManager::seen(int agv, int parts) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  trays_[agv].seen = parts;
+}
+
+void TrayManager::update(const ros::Time & now) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  bool notify = false;
+  for (std::map<int, Tray>::iterator it = trays_.begin(); it != trays_.end(); ++it) {
+    Tray & tray = it->second;
+    switch (tray.phase) {
+      case kIdle:
+        break;
+      case kFilling: {
+        bool done = tray.watched ? tray.seen >= tray.expected : tray.placed >= tray.expected;
+        if (!done && tray.placed >= tray.expected && (now - tray.since).toSec() > kConfirmTimeout) {
+          ROS_WARN_STREAM("Tray camera sees " << tray.seen << " of " << tray.expected << " parts on agv"
+            << it->first << "; submitting anyway.");
+          done = true;
+        }
+        if (done) {
+          tray.phase = kSubmitting;
+          ++changes_;
+          tray.since = now;
+          tray.call_pending = true;
+          tray.call_done = false;
+          notify = true;
+        }
+        break;
+      }
+      case kSubmitting:
+        if (tray.call_done && tray.call_ok) {
+          submitted(tray, now);
+          tray.phase = kInTransit;
+          ++changes_;
+          tray.since = now;
+        } else if (tray.call_done && (now - tray.since).toSec() > kRetryInterval) {
+          ROS_WARN_STREAM("Submitting the tray on agv" << it->first << " failed, retrying.");
+          tray.since = now;
+          tray.call_pending = true;
+          tray.call_done = false;
+          notify = true;
+        }
+        break;
+      case kInTransit:
+        if ((now - tray.since).toSec() >= transit_) {
+          tray.phase = kIdle;
+          ++changes_;
+          tray.kit = -1;
+          tray.placed = 0;
+          tray.seen = 0;
+          tray.since = now;
+        }
+        break;
+    }
+  }
+  if (!notify) {
+    return;
+  }
+  if (worker_.joinable()) {
+    changed_.notify_all();
+    return;
+  }
+  // No worker: call inline; the result is picked up on the next update.
+  for (std::map<int, Tray>::iterator it = trays_.begin(); it != trays_.end(); ++it) {
+    if (it->second.call_pending) {
+      it->second.call_pending = false;
+      const std::string kit_type = it->second.kit_type;
+      lock.unlock();
+      const bool ok = call(it->first, kit_type);
+      lock.lock();
+      it->second.call_done = true;
+      it->second.call_ok = ok;
+    }
+  }
+}
+
+TrayManager::Phase TrayManager::phase(int agv) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::map<int, Tray>::const_iterator it = trays_.find(agv);
+  return it == trays_.end() ? kIdle : it->second.phase;
+}
+
+size_t TrayManager::changes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return changes_;
+}
+
+size_t TrayManager::kits_submitted() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return kits_submitted_;
+}
+
+size_t TrayManager::orders_completed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return orders_completed_;
+}
+
+double TrayManager::orders_per_minute() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const double minutes = (last_completed_ - first_start_).toSec() / 60.0;
+  return orders_completed_ > 0 && minutes > 0.0 ? orders_completed_ / minutes : 0.0;
+}
+
+void TrayManager::write(std::ostream & out) const {
+  const double rate = orders_per_minute();
+  std::lock_guard<std::mutex> lock(mutex_);
+  out << "kits submitted:    " << kits_submitted_ << "\n"
+      << "orders completed:  " << orders_completed_ << "\n"
+      << "orders per minute: " << std::fixed << std::setprecision(2) << rate << "\n";
+  out.unsetf(std::ios::floatfield);
+  for (std::map<int, Tray>::const_iterator it = trays_.begin(); it != trays_.end(); ++it) {
+    out << "agv" << it->first << ":              " << name(it->second.phase) << "\n";
+  }
+}
+
+const char * TrayManager::name(Phase phase) {
+  switch (phase) {
+    case kIdle: return "idle";
+    case kFilling: return "filling";
+    case kSubmitting: return "submitting";
+    case kInTransit: return "in transit";
+    default: return "unknown";
+  }
+}
+
+bool TrayManager::call(int agv, const std::string & kit_type) {
+  osrf_gear::AGVControl srv;
+  srv.request.kit_type = kit_type;
+  return transport_.call_agv(agv, srv) && srv.response.success;
+}
+
+void TrayManager::submitted(Tray & tray, const ros::Time & now) {
+  ++kits_submitted_;
+  if (++order_kits_submitted_[tray.order_id] == tray.order_kits) {
+    ++orders_completed_;
+    last_completed_ = now;
+  }
+}
+
+void TrayManager::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_) {
+    std::map<int, Tray>::iterator pending = trays_.end();
+    changed_.wait(lock, [this, &pending]() {
+      for (pending = trays_.begin(); pending != trays_.end(); ++pending) {
+        if (pending->second.call_pending) {
+          return true;
+        }
+      }
+      return !running_;
+    });
+    if (!running_) {
+      break;
+    }
+    pending->second.call_pending = false;
+    const int agv = pending->first;
+    const std::string kit_type = pending->second.kit_type;
+
+    // Make the service call without holding the lock.
+    lock.unlock();
+    const bool ok = call(agv, kit_type);
+    lock.lock();
+
+    // Trays are never erased, so the entry is still there.
+    Tray & tray = trays_[agv];
+    tray.call_done = true;
+    tray.call_ok = ok;
+  }
+}
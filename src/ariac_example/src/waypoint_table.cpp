@@ -0,0 +1,66 @@
+#include "ariac_example/waypoint_table.h"
+
+#include <algorithm>
+
+const int WaypointTable::kConveyor;
+
+WaypointTable::WaypointTable() {
+  // Joint order: elbow, linear_arm_actuator, shoulder_lift, shoulder_pan,
+  // wrist_1, wrist_2, wrist_3.
+  ready_ = {{1.51, 0.0, -1.13, 3.14, 3.58, -1.51, 0.0}};
+
+  add_bin_slot(7, {{1.76, 0.42, -1.0, 2.0, 3.58, -1.51, 0.0}},
+                  {{1.76, 0.42, -0.47, 3.23, 3.58, -1.51, 0.0}});
+  add_bin_slot(7, {{1.76, 0.5, -1.0, 2.0, 3.58, -1.51, 0.0}},
+                  {{2.0, 0.44, -0.48, 3.50, 3.58, -1.51, 0.0}});
+  add_bin_slot(6, {{1.76, -0.46, -1.0, 2.0, 3.58, -1.51, 0.0}},
+                  {{2.0, -0.37, -0.50, 3.50, 3.52, -1.51, 0.0}});
+  add_bin_slot(kConveyor, {{1.62, -0.09, -1.06, -0.08, 4.14, -1.57, 0.0}},
+                          {{1.70, -0.09, -0.82, -0.08, 3.83, -1.57, 0.0}});
+
+  add_tray_slot(1, {{1.76, 2.06, -0.63, 1.5, 3.27, -1.51, 0.0}});
+  // AGV 2: AGV 1 mirrored across the rail centre and solved by IK, not yet verified in the simulation,
+  // so kits only go to AGV 2 when ~agvs lists it.
+  add_tray_slot(2, {{1.81, -2.1, -0.70, 4.39, 3.60, -1.57, 0.0}});
+}
+
+void WaypointTable::add_bin_slot(int bin, const JointPositions & approach, const JointPositions & grasp) {
+  PickWaypoints waypoints;
+  waypoints.approach = approach;
+  waypoints.grasp = grasp;
+  bins_[bin].push_back(waypoints);
+}
+
+void WaypointTable::add_tray_slot(int agv, const JointPositions & goal) {
+  trays_[agv].push_back(goal);
+}
+
+bool WaypointTable::pick(int bin, int slot, PickWaypoints & waypoints) const {
+  std::map<int, std::vector<PickWaypoints> >::const_iterator it = bins_.find(bin);
+  if (it == bins_.end() || it->second.empty()) {
+    return false;
+  }
+  const size_t index = std::min<size_t>(slot, it->second.size() - 1);
+  waypoints = it->second[index];
+  return true;
+}
+
+bool WaypointTable::place(int agv, int slot, JointPositions & goal) const {
+  std::map<int, std::vector<JointPositions> >::const_iterator it = trays_.find(agv);
+  if (it == trays_.end() || it->second.empty()) {
+    return false;
+  }
+  const size_t index = std::min<size_t>(slot, it->second.size() - 1);
+  goal = it->second[index];
+  return true;
+}
+
+size_t WaypointTable::bin_slots(int bin) const {
+  std::map<int, std::vector<PickWaypoints> >::const_iterator it = bins_.find(bin);
+  return it == bins_.end() ? 0 : it->second.size();
+}
+
+size_t WaypointTable::tray_slots(int agv) const {
+  std::map<int, std::vector<JointPositions> >::const_iterator it = trays_.find(agv);
+  return it == trays_.end() ? 0 : it->second.size();
+}
@@ -0,0 +1,242 @@
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "ariac_example/competition.h"
+#include "ariac_example/trajectory_builder.h"
+
+/*
+ * Allocation checks for the control path. Global operator new is replaced
+ * with one that counts the calls made by the current thread while counting
+ * is on, so the event log, gripper and tray worker threads are not counted.
+ * Each test warms up first, then requires that nothing more is allocated.
+ *
+ * This replaces operator new for the whole executable, so it is a test
+ * target of its own.
+ */
+
+namespace {
+
+thread_local bool counting = false;
+thread_local size_t allocations = 0;
+
+/// Counts the allocations made by this thread while it is alive.
+class AllocationCounter
+{
+public:
+  AllocationCounter() {
+    allocations = 0;
+    counting = true;
+  }
+  ~AllocationCounter() {
+    counting = false;
+  }
+  size_t count() const {
+    return allocations;
+  }
+};
+
+}  // namespace
+
+void * operator new(size_t size) {
+  if (counting) {
+    ++allocations;
+  }
+  void * p = std::malloc(size > 0 ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void * operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void * p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void * p) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+JointPositions filled(double value) {
+  JointPositions q;
+  q.fill(value);
+  return q;
+}
+
+/// Accepts every command and service call.
+class NullTransport : public Transport
+{
+public:
+  void publish_arm_command(const trajectory_msgs::JointTrajectory &) {}
+  bool call_gripper(osrf_gear::VacuumGripperControl & srv) {
+    srv.response.success = true;
+    return true;
+  }
+  bool call_agv(int, osrf_gear::AGVControl & srv) {
+    srv.response.success = true;
+    return true;
+  }
+  void publish_diagnostics(const diagnostic_msgs::DiagnosticArray &) {}
+};
+
+/*
+ * @brief Drives MyCompetitionClass through bin-to-tray cycles, as the simulation would
+ *
+ * Every message is built up front. Each pose has two identical joint state
+ * messages, used in turn, so every tick sees a new one without building it.
+ */
+class Cell
+{
+public:
+  static const int kParts = 4;
+
+  Cell()
+  : node_(transport_, config()), now_(100.0)
+  {
+    // Simulated time, stepped by tick().
+    ros::Time::setNow(now_);
+    node_.warm_up();
+    // Every frame where the gripper is, so each grasp and place check passes at once.
+    const char * const frames[] = {
+      "/bin6_frame", "/bin7_frame", "/agv1_load_point_frame", "/agv2_load_point_frame", "/vacuum_gripper_link"
+    };
+    for (size_t i = 0; i < sizeof(frames) / sizeof(frames[0]); ++i) {
+      const tf::Transform identity(tf::Quaternion(0, 0, 0, 1), tf::Vector3(0, 0, 0));
+      node_.add_transform(tf::StampedTransform(identity, now_, "/world", frames[i]), true);
+    }
+
+    WaypointTable table;
+    PickWaypoints pick;
+    JointPositions place;
+    table.pick(6, 0, pick);
+    table.place(1, 0, place);
+    ready_ = joint_states(table.ready());
+    approach_ = joint_states(pick.approach);
+    grasp_ = joint_states(pick.grasp);
+    place_ = joint_states(place);
+    for (int attached = 0; attached < 2; ++attached) {
+      osrf_gear::VacuumGripperState::Ptr state(new osrf_gear::VacuumGripperState());
+      state->enabled = attached;
+      state->attached = attached;
+      gripper_[attached] = state;
+    }
+
+    // To ready, then one kit of gear parts, all from bin 6 to agv1.
+    tick(ready_, false);
+    tick(ready_, false);
+    osrf_gear::Order::Ptr order(new osrf_gear::Order());
+    order->order_id = "order_0";
+    osrf_gear::Kit kit;
+    kit.kit_type = "kit_0";
+    osrf_gear::KitObject object;
+    object.type = "gear_part";
+    kit.objects.assign(kParts, object);
+    order->kits.push_back(kit);
+    node_.order_callback(order);
+  }
+
+  static CompetitionConfig config() {
+    ros::Time::init();
+    CompetitionConfig config;
+    config.listen_tf = false;
+    config.gripper_worker = false;
+    config.event_console = false;
+    config.tf_max_age = 0.0;
+    // The 1 Hz report formats its figures into strings by design; it is off here.
+    config.diagnostics_period = 0.0;
+    return config;
+  }
+
+  /// Pick one part from the bin and place it on the tray; false if the task was not done.
+  bool cycle() {
+    const size_t pending = node_.pending_tasks();
+    tick(place_, false);   // Idle: off to the bin.
+    tick(approach_, false);  // Over the bin: gripper on.
+    tick(grasp_, true);    // Attached: off to the tray.
+    tick(approach_, true);
+    tick(place_, true);    // Over the tray: gripper off.
+    tick(place_, false);   // Detached: the next part.
+    return pending > 0 && node_.pending_tasks() == pending - 1;
+  }
+
+  size_t pending_tasks() const {
+    return node_.pending_tasks();
+  }
+
+private:
+  typedef std::vector<sensor_msgs::JointState::ConstPtr> JointStates;
+
+  static JointStates joint_states(const JointPositions & positions) {
+    JointStates states;
+    for (int copy = 0; copy < 2; ++copy) {
+      sensor_msgs::JointState::Ptr state(new sensor_msgs::JointState());
+      state->name = arm_joint_names();
+      state->position.assign(positions.begin(), positions.end());
+      states.push_back(state);
+    }
+    return states;
+  }
+
+  void tick(const JointStates & joints, bool attached) {
+    now_ += ros::Duration(0.1);
+    ros::Time::setNow(now_);
+    node_.joint_state_callback(joints[ticks_ % joints.size()]);
+    node_.gripper_state_attatch_callback(gripper_[attached]);
+    node_.control_tick();
+    ++ticks_;
+  }
+
+  NullTransport transport_;
+  MyCompetitionClass node_;
+  ros::Time now_;
+  size_t ticks_ = 0;
+  JointStates ready_, approach_, grasp_, place_;
+  osrf_gear::VacuumGripperState::ConstPtr gripper_[2];
+};
+
+}  // namespace
+
+TEST(Allocations, TrajectoryBuilderAfterWarmUp) {
+  TrajectoryBuilder builder;
+  const JointPositions start = filled(0.0), a = filled(0.5), b = filled(1.0);
+  std::vector<const JointPositions *> longest(TrajectoryBuilder::kMaxPoints, &a);
+  builder.build(start, longest);  // The first build of each length sizes the template.
+  builder.build(start, {&a});
+
+  size_t allocated;
+  {
+    AllocationCounter counter;
+    for (int i = 0; i < 100; ++i) {
+      builder.build(start, {&a, &b});
+      builder.build(start, {&b});
+      builder.build(start, longest);
+    }
+    allocated = counter.count();
+  }
+  EXPECT_EQ(0u, allocated);
+}
+
+TEST(Allocations, ControlTickAfterWarmUp) {
+  Cell cell;
+  ASSERT_TRUE(cell.cycle());  // The first part fills whatever is sized lazily.
+
+  size_t allocated;
+  bool cycled = true;
+  {
+    AllocationCounter counter;
+    for (int part = 1; part < Cell::kParts; ++part) {
+      cycled = cycled && cell.cycle();
+    }
+    allocated = counter.count();
+  }
+  ASSERT_TRUE(cycled);
+  EXPECT_EQ(0u, allocated);
+  EXPECT_EQ(0u, cell.pending_tasks());
+}
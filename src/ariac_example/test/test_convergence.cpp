@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include "ariac_example/convergence.h"
+
+namespace {
+
+JointPositions filled(double value) {
+  JointPositions q;
+  q.fill(value);
+  return q;
+}
+
+}  // namespace
+
+TEST(ConvergenceCheck, DefaultToleranceOnEveryJoint) {
+  ConvergenceCheck check;
+  const JointPositions goal = filled(1.0);
+  EXPECT_TRUE(check.converged(goal, goal));
+  EXPECT_TRUE(check.converged(goal, filled(1.04)));
+  EXPECT_TRUE(check.converged(goal, filled(0.96)));
+  EXPECT_FALSE(check.converged(goal, filled(1.05)));  // the bound itself is outside
+  EXPECT_FALSE(check.converged(goal, filled(0.9)));
+}
+
+TEST(ConvergenceCheck, FractionalErrorsAreNotTruncated) {
+  // An integer abs() would have turned each of these errors into zero.
+  ConvergenceCheck check;
+  const JointPositions goal = filled(0.0);
+  EXPECT_FALSE(check.converged(goal, filled(0.9)));
+  EXPECT_FALSE(check.converged(goal, filled(-0.9)));
+  EXPECT_FALSE(check.converged(filled(2.7), filled(2.1)));
+}
+
+TEST(ConvergenceCheck, AnySingleJointOutsideFails) {
+  // Every joint is counted: one bad joint fails the check wherever it is.
+  ConvergenceCheck check;
+  const JointPositions goal = filled(0.5);
+  for (size_t i = 0; i < kNumArmJoints; ++i) {
+    JointPositions position = goal;
+    position[i] += 0.2;
+    EXPECT_FALSE(check.converged(goal, position)) << "joint " << i;
+    position[i] = goal[i] - 0.2;
+    EXPECT_FALSE(check.converged(goal, position)) << "joint " << i;
+  }
+}
+
+TEST(ConvergenceCheck, PerJointTolerance) {
+  ConvergenceCheck check;
+  // Loose on the rail (metres), tight on wrist_3.
+  const std::vector<double> tolerance = {0.05, 0.2, 0.05, 0.05, 0.05, 0.05, 0.01};
+  ASSERT_TRUE(check.set_position_tolerance(tolerance));
+  const JointPositions goal = filled(0.0);
+  JointPositions position = goal;
+  position[1] = 0.15;
+  EXPECT_TRUE(check.converged(goal, position));
+  position[1] = 0.25;
+  EXPECT_FALSE(check.converged(goal, position));
+  position = goal;
+  position[6] = 0.02;
+  EXPECT_FALSE(check.converged(goal, position));
+  position[6] = 0.005;
+  EXPECT_TRUE(check.converged(goal, position));
+}
+
+TEST(ConvergenceCheck, InvalidToleranceIsIgnored) {
+  ConvergenceCheck check;
+  EXPECT_FALSE(check.set_position_tolerance(std::vector<double>(6, 0.1)));
+  std::vector<double> tolerance(kNumArmJoints, 0.1);
+  tolerance[3] = 0.0;
+  EXPECT_FALSE(check.set_position_tolerance(tolerance));
+  // Still the 0.05 default.
+  EXPECT_FALSE(check.converged(filled(0.0), filled(0.07)));
+}
+
+TEST(ConvergenceCheck, SettleVelocity) {
+  ConvergenceCheck check;
+  const JointPositions goal = filled(1.0);
+  const JointPositions moving = filled(0.3);
+  EXPECT_FALSE(check.uses_velocity());
+  EXPECT_TRUE(check.reached(goal, goal, &moving));  // off by default
+
+  check.set_settle_velocity(0.1);
+  EXPECT_TRUE(check.uses_velocity());
+  EXPECT_FALSE(check.reached(goal, goal, &moving));
+  EXPECT_TRUE(check.reached(goal, goal, NULL));  // no velocities to wait for
+  const JointPositions still = filled(0.05);
+  EXPECT_TRUE(check.reached(goal, goal, &still));
+  for (size_t i = 0; i < kNumArmJoints; ++i) {
+    JointPositions velocity = still;
+    velocity[i] = -0.1;  // the limit itself still counts as moving
+    EXPECT_FALSE(check.settled(velocity)) << "joint " << i;
+  }
+  // Settled but not there.
+  EXPECT_FALSE(check.reached(goal, filled(1.2), &still));
+}